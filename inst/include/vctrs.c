@@ -4,6 +4,7 @@ SEXP (*vec_proxy)(SEXP) = NULL;
 SEXP (*vec_restore)(SEXP, SEXP, SEXP) = NULL;
 SEXP (*vec_assign_impl)(SEXP, SEXP, SEXP) = NULL;
 SEXP (*vec_slice_impl)(SEXP, SEXP) = NULL;
+SEXP (*vec_slice_trusted)(SEXP, SEXP) = NULL;
 SEXP (*vec_names)(SEXP) = NULL;
 SEXP (*vec_set_names)(SEXP, SEXP) = NULL;
 SEXP (*vec_chop)(SEXP, SEXP) = NULL;
@@ -13,6 +14,7 @@ void vctrs_init_api() {
   vec_restore = (SEXP (*)(SEXP, SEXP, SEXP)) R_GetCCallable("vctrs", "vec_restore");
   vec_assign_impl = (SEXP (*)(SEXP, SEXP, SEXP)) R_GetCCallable("vctrs", "vec_assign_impl");
   vec_slice_impl = (SEXP (*)(SEXP, SEXP)) R_GetCCallable("vctrs", "vec_slice_impl");
+  vec_slice_trusted = (SEXP (*)(SEXP, SEXP)) R_GetCCallable("vctrs", "vec_slice_trusted");
   vec_names = (SEXP (*)(SEXP)) R_GetCCallable("vctrs", "vec_names");
   vec_set_names = (SEXP (*)(SEXP, SEXP)) R_GetCCallable("vctrs", "vec_set_names");
   vec_chop = (SEXP (*)(SEXP, SEXP)) R_GetCCallable("vctrs", "vec_chop");
@@ -9,6 +9,9 @@ extern SEXP (*vec_proxy)(SEXP);
 extern SEXP (*vec_restore)(SEXP, SEXP, SEXP);
 extern SEXP (*vec_assign_impl)(SEXP, SEXP, SEXP);
 extern SEXP (*vec_slice_impl)(SEXP, SEXP);
+// Performs no bounds or `NA` checks. The subscript must be an integer
+// vector of 1-based, in-bounds locations without missing values.
+extern SEXP (*vec_slice_trusted)(SEXP, SEXP);
 extern SEXP (*vec_names)(SEXP);
 extern SEXP (*vec_set_names)(SEXP, SEXP);
 extern SEXP (*vec_chop)(SEXP, SEXP);
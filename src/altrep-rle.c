@@ -1,4 +1,5 @@
 #include "vctrs.h"
+#include "utils.h"
 #include "altrep-rle.h"
 #include "altrep.h"
 
@@ -13,36 +14,302 @@ SEXP altrep_rle_Make(SEXP input) {
   return R_NilValue;
 }
 
+SEXP vctrs_new_rle(SEXP values, SEXP lengths) {
+  Rf_error("Need R 3.5+ for Altrep support.");
+  return R_NilValue;
+}
+
+SEXP altrep_rle_slice_seq(SEXP x, R_len_t start, R_len_t size) {
+  return NULL;
+}
+
+SEXP altrep_rle_runs(SEXP x) {
+  return R_NilValue;
+}
+
 #else
 
 
 // Initialised at load time
 R_altrep_class_t altrep_rle_class;
+R_altrep_class_t altrep_rle_int_class;
+R_altrep_class_t altrep_rle_dbl_class;
+R_altrep_class_t altrep_rle_lgl_class;
+
+// Run length encoded vectors store their runs in `data1`, as a list
+// of the run `values`, the cumulative run lengths `ends`, and a
+// `window` of the runs. The window is an integer vector of an offset
+// and a size, so that element `i` of the vector is element
+// `offset + i` of the runs. Contiguous slices share the runs of the
+// sliced vector and only differ by their window.
+//
+// The run containing element `i` is the first run whose end is
+// greater than `i`, which is found by binary search. Runs are never
+// empty. The materialized vector is cached in `data2`. Since it can
+// be written to through `DATAPTR()`, the runs are no longer used once
+// the vector is materialized.
+
+#define RLE_VALUES(x) VECTOR_ELT(R_altrep_data1(x), 0)
+#define RLE_ENDS(x) VECTOR_ELT(R_altrep_data1(x), 1)
+#define RLE_WINDOW(x) VECTOR_ELT(R_altrep_data1(x), 2)
+
+static R_altrep_class_t rle_class(SEXPTYPE type) {
+  switch (type) {
+  case STRSXP: return altrep_rle_class;
+  case INTSXP: return altrep_rle_int_class;
+  case REALSXP: return altrep_rle_dbl_class;
+#if (R_VERSION >= R_Version(3, 6, 0))
+  case LGLSXP: return altrep_rle_lgl_class;
+#endif
+  default: Rf_errorcall(R_NilValue, "`values` must be a character, integer, double, or logical vector.");
+  }
+}
+
+static bool is_altrep_rle(SEXP x) {
+  if (!ALTREP(x)) {
+    return false;
+  }
+
+  switch (TYPEOF(x)) {
+  case STRSXP: return R_altrep_inherits(x, altrep_rle_class);
+  case INTSXP: return R_altrep_inherits(x, altrep_rle_int_class);
+  case REALSXP: return R_altrep_inherits(x, altrep_rle_dbl_class);
+#if (R_VERSION >= R_Version(3, 6, 0))
+  case LGLSXP: return R_altrep_inherits(x, altrep_rle_lgl_class);
+#endif
+  default: return false;
+  }
+}
+
+static SEXP new_rle(SEXP values, SEXP ends, R_len_t offset, R_len_t size) {
+  SEXP data1 = PROTECT(Rf_allocVector(VECSXP, 3));
+  SET_VECTOR_ELT(data1, 0, values);
+  SET_VECTOR_ELT(data1, 1, ends);
+
+  SEXP window = Rf_allocVector(INTSXP, 2);
+  SET_VECTOR_ELT(data1, 2, window);
+  INTEGER(window)[0] = offset;
+  INTEGER(window)[1] = size;
+
+  SEXP out = R_new_altrep(rle_class(TYPEOF(values)), data1, R_NilValue);
+  MARK_NOT_MUTABLE(out);
+
+  UNPROTECT(1);
+  return out;
+}
+
+// [[ register() ]]
+SEXP vctrs_new_rle(SEXP values, SEXP lengths) {
+  if (OBJECT(values)) {
+    Rf_errorcall(R_NilValue, "`values` must be a bare vector.");
+  }
+  rle_class(TYPEOF(values));
+
+  if (TYPEOF(lengths) != INTSXP) {
+    Rf_errorcall(R_NilValue, "`lengths` must be an integer vector.");
+  }
+
+  R_len_t n = Rf_length(lengths);
+
+  if (Rf_length(values) != n) {
+    Rf_errorcall(R_NilValue, "`values` and `lengths` must have the same size.");
+  }
+
+  const int* p_lengths = INTEGER_RO(lengths);
+
+  // Empty runs are dropped
+  R_len_t n_runs = 0;
 
+  for (R_len_t i = 0; i < n; ++i) {
+    int elt = p_lengths[i];
 
+    if (elt == NA_INTEGER || elt < 0) {
+      Rf_errorcall(R_NilValue, "`lengths` must be non-negative integers.");
+    }
+
+    n_runs += (elt != 0);
+  }
+
+  SEXP loc = PROTECT(Rf_allocVector(INTSXP, n_runs));
+  int* p_loc = INTEGER(loc);
+
+  SEXP ends = PROTECT(Rf_allocVector(INTSXP, n_runs));
+  int* p_ends = INTEGER(ends);
+
+  int64_t end = 0;
+  R_len_t run = 0;
+
+  for (R_len_t i = 0; i < n; ++i) {
+    if (p_lengths[i] == 0) {
+      continue;
+    }
+
+    end += p_lengths[i];
+
+    if (end > INT_MAX) {
+      Rf_errorcall(R_NilValue, "Run length encoded vectors must have a size that fits in an integer.");
+    }
+
+    p_loc[run] = i + 1;
+    p_ends[run] = (int) end;
+    ++run;
+  }
+
+  // Run values are stored as bare vectors
+  values = PROTECT(vec_slice_trusted(values, loc));
+
+  if (ATTRIB(values) != R_NilValue) {
+    values = Rf_shallow_duplicate(values);
+    SET_ATTRIB(values, R_NilValue);
+  }
+  PROTECT(values);
+
+  SEXP out = new_rle(values, ends, 0, (R_len_t) end);
+
+  UNPROTECT(4);
+  return out;
+}
+
+// For testing. Creates a character vector from a named integer vector
+// of run lengths, whose names are the run values.
 SEXP altrep_rle_Make(SEXP input) {
-  SEXP res = R_new_altrep(altrep_rle_class, input, R_NilValue);
-  MARK_NOT_MUTABLE(res);
-  return res;
+  SEXP values = PROTECT(Rf_getAttrib(input, R_NamesSymbol));
+  SEXP lengths = PROTECT(Rf_shallow_duplicate(input));
+  Rf_setAttrib(lengths, R_NamesSymbol, R_NilValue);
+
+  SEXP out = vctrs_new_rle(values, lengths);
+
+  UNPROTECT(2);
+  return out;
 }
 
-// ALTREP methods -------------------
-// The length of the object
-inline R_xlen_t altrep_rle_Length(SEXP vec) {
-  SEXP data2 = R_altrep_data2(vec);
-  if (data2 != R_NilValue) {
-    return Rf_xlength(data2);
+/**
+ * Slice a run length encoded vector with a contiguous sequence
+ *
+ * The slice shares the runs of `x`.
+ *
+ * @param start The 0-based location of the first element.
+ * @param size The size of the slice.
+ * @return A run length encoded vector, or `NULL` if `x` is not a
+ *   run length encoded vector or is already materialized.
+ */
+SEXP altrep_rle_slice_seq(SEXP x, R_len_t start, R_len_t size) {
+  if (!is_altrep_rle(x) || R_altrep_data2(x) != R_NilValue) {
+    return NULL;
+  }
+
+  R_len_t offset = INTEGER_RO(RLE_WINDOW(x))[0];
+  return new_rle(RLE_VALUES(x), RLE_ENDS(x), offset + start, size);
+}
+
+
+// Returns the run containing element `i` of the runs
+static inline R_len_t rle_find_run(const int* p_ends, R_len_t n_runs, R_xlen_t i) {
+  R_len_t lo = 0;
+  R_len_t hi = n_runs - 1;
+
+  while (lo < hi) {
+    R_len_t mid = lo + (hi - lo) / 2;
+
+    if (p_ends[mid] > i) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+
+  return lo;
+}
+
+struct rle_info {
+  SEXP values;
+  const int* p_ends;
+  R_len_t n_runs;
+  R_len_t offset;
+  R_len_t size;
+  // The runs overlapping the window are `[first, last)`
+  R_len_t first;
+  R_len_t last;
+};
+
+static struct rle_info rle_info(SEXP x) {
+  SEXP ends = RLE_ENDS(x);
+  const int* p_window = INTEGER_RO(RLE_WINDOW(x));
+
+  struct rle_info info = {
+    .values = RLE_VALUES(x),
+    .p_ends = INTEGER_RO(ends),
+    .n_runs = Rf_length(ends),
+    .offset = p_window[0],
+    .size = p_window[1],
+    .first = 0,
+    .last = 0
+  };
+
+  if (info.size) {
+    info.first = rle_find_run(info.p_ends, info.n_runs, info.offset);
+    info.last = rle_find_run(info.p_ends, info.n_runs, info.offset + info.size - 1) + 1;
+  }
+
+  return info;
+}
+
+// Returns the run containing element `i` of the window
+static inline R_len_t rle_info_find_run(const struct rle_info* p_info, R_xlen_t i) {
+  return rle_find_run(p_info->p_ends, p_info->n_runs, p_info->offset + i);
+}
+
+// Returns the end of run `run`, relative to the window
+static inline R_len_t rle_info_run_end(const struct rle_info* p_info, R_len_t run) {
+  R_len_t end = p_info->p_ends[run] - p_info->offset;
+  return (end < p_info->size) ? end : p_info->size;
+}
+
+/**
+ * Runs of a run length encoded vector
+ *
+ * Adjacent runs might have equal values.
+ *
+ * @return A list of the run `values` and their `lengths`, or
+ *   `R_NilValue` if `x` is not a bare run length encoded vector or is
+ *   already materialized.
+ */
+SEXP altrep_rle_runs(SEXP x) {
+  if (!is_altrep_rle(x) || R_altrep_data2(x) != R_NilValue) {
+    return R_NilValue;
+  }
+  if (OBJECT(x) || has_dim(x)) {
+    return R_NilValue;
   }
 
-  R_xlen_t sz = 0;
-  SEXP rle = R_altrep_data1(vec);
-  int* rle_p = INTEGER(rle);
+  struct rle_info info = rle_info(x);
+  R_len_t n_runs = info.last - info.first;
 
-  for (R_xlen_t i = 0; i < Rf_xlength(rle); ++i) {
-    sz += rle_p[i];
+  SEXP loc = PROTECT(compact_seq(info.first, n_runs, true));
+  SEXP values = PROTECT(vec_slice_trusted(info.values, loc));
+
+  SEXP lengths = PROTECT(Rf_allocVector(INTSXP, n_runs));
+  int* p_lengths = INTEGER(lengths);
+
+  R_len_t start = 0;
+  for (R_len_t i = 0; i < n_runs; ++i) {
+    R_len_t end = rle_info_run_end(&info, info.first + i);
+    p_lengths[i] = end - start;
+    start = end;
   }
 
-  return sz;
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(out, 0, values);
+  SET_VECTOR_ELT(out, 1, lengths);
+
+  UNPROTECT(4);
+  return out;
+}
+
+// ALTREP methods -------------------
+// The length of the object
+R_xlen_t altrep_rle_Length(SEXP vec) {
+  return INTEGER_RO(RLE_WINDOW(vec))[1];
 }
 
 // What gets printed when .Internal(inspect()) is used
@@ -51,135 +318,589 @@ Rboolean altrep_rle_Inspect(SEXP x,
                             int deep,
                             int pvec,
                             void (*inspect_subtree)(SEXP, int, int, int)) {
-  Rprintf("vctrs_rle (len=%d, materialized=%s)\n",
-          altrep_rle_Length(x),
+  struct rle_info info = rle_info(x);
+
+  Rprintf("vctrs_rle %s (len=%d, runs=%d, materialized=%s)\n",
+          Rf_type2char(TYPEOF(x)),
+          info.size,
+          info.last - info.first,
           R_altrep_data2(x) != R_NilValue ? "T" : "F");
   return TRUE;
 }
 
-// ALTSTRING methods -----------------
+// Duplicates share the runs. A materialized vector might have been
+// modified, so it is duplicated as usual.
+static SEXP altrep_rle_Duplicate(SEXP x, Rboolean deep) {
+  if (R_altrep_data2(x) != R_NilValue) {
+    return NULL;
+  }
+
+  return R_new_altrep(rle_class(TYPEOF(x)), R_altrep_data1(x), R_NilValue);
+}
+
+// Only the runs inside the window are serialized, so that slices
+// don't carry the runs of their parent. A materialized vector might
+// have been modified, so it is serialized as usual.
+static SEXP altrep_rle_Serialized_state(SEXP x) {
+  if (R_altrep_data2(x) != R_NilValue) {
+    return NULL;
+  }
+
+  struct rle_info info = rle_info(x);
+
+  if (info.offset == 0 && info.first == 0 && info.last == info.n_runs) {
+    return R_altrep_data1(x);
+  }
+
+  R_len_t n_runs = info.last - info.first;
+
+  SEXP loc = PROTECT(compact_seq(info.first, n_runs, true));
+  SEXP values = PROTECT(vec_slice_trusted(info.values, loc));
+
+  SEXP ends = PROTECT(Rf_allocVector(INTSXP, n_runs));
+  int* p_ends = INTEGER(ends);
+
+  for (R_len_t i = 0; i < n_runs; ++i) {
+    p_ends[i] = rle_info_run_end(&info, info.first + i);
+  }
+
+  SEXP window = PROTECT(Rf_allocVector(INTSXP, 2));
+  INTEGER(window)[0] = 0;
+  INTEGER(window)[1] = info.size;
+
+  SEXP state = PROTECT(Rf_allocVector(VECSXP, 3));
+  SET_VECTOR_ELT(state, 0, values);
+  SET_VECTOR_ELT(state, 1, ends);
+  SET_VECTOR_ELT(state, 2, window);
+
+  UNPROTECT(5);
+  return state;
+}
+
+static SEXP altrep_rle_Unserialize(SEXP cls, SEXP state) {
+  SEXP window = VECTOR_ELT(state, 2);
+
+  return new_rle(VECTOR_ELT(state, 0),
+                 VECTOR_ELT(state, 1),
+                 INTEGER(window)[0],
+                 INTEGER(window)[1]);
+}
+
+// ALTVEC methods -------------------
+
+#define RLE_MATERIALIZE(CTYPE, CONST_DEREF, DEREF)              \
+  const CTYPE* p_values = CONST_DEREF(info.values);             \
+  CTYPE* p_out = DEREF(out);                                    \
+                                                                \
+  R_len_t start = 0;                                            \
+  for (R_len_t run = info.first; run < info.last; ++run) {      \
+    CTYPE value = p_values[run];                                \
+    R_len_t end = rle_info_run_end(&info, run);                 \
+    for (R_len_t j = start; j < end; ++j) {                     \
+      p_out[j] = value;                                         \
+    }                                                           \
+    start = end;                                                \
+  }
+
+static SEXP altrep_rle_Materialize(SEXP vec) {
+  SEXP data2 = R_altrep_data2(vec);
+  if (data2 != R_NilValue) {
+    return data2;
+  }
+
+  struct rle_info info = rle_info(vec);
+
+  SEXP out = PROTECT(Rf_allocVector(TYPEOF(vec), info.size));
+
+  switch (TYPEOF(vec)) {
+  case LGLSXP: { RLE_MATERIALIZE(int, LOGICAL_RO, LOGICAL); break; }
+  case INTSXP: { RLE_MATERIALIZE(int, INTEGER_RO, INTEGER); break; }
+  case REALSXP: { RLE_MATERIALIZE(double, REAL_RO, REAL); break; }
+  case STRSXP: {
+    R_len_t start = 0;
+    for (R_len_t run = info.first; run < info.last; ++run) {
+      SEXP value = STRING_ELT(info.values, run);
+      R_len_t end = rle_info_run_end(&info, run);
+      for (R_len_t j = start; j < end; ++j) {
+        SET_STRING_ELT(out, j, value);
+      }
+      start = end;
+    }
+    break;
+  }
+  default: Rf_error("Internal error: Unexpected type in `altrep_rle_Materialize()`.");
+  }
+
+  R_set_altrep_data2(vec, out);
+
+  UNPROTECT(1);
+  return out;
+}
+
+#undef RLE_MATERIALIZE
+
+void* altrep_rle_Dataptr(SEXP vec, Rboolean writeable) {
+  return STDVEC_DATAPTR(altrep_rle_Materialize(vec));
+}
+
+const void* altrep_rle_Dataptr_or_null(SEXP vec) {
+  SEXP data2 = R_altrep_data2(vec);
+  if (data2 == R_NilValue)
+    return NULL;
+
+  return STDVEC_DATAPTR(data2);
+}
+
+#define RLE_EXTRACT_SUBSET(CTYPE, CONST_DEREF, DEREF, NA_VALUE)         \
+  const CTYPE* p_values = CONST_DEREF(info.values);                     \
+  CTYPE* p_out = DEREF(out);                                            \
+                                                                        \
+  for (R_len_t i = 0; i < index_n; ++i) {                               \
+    int index_elt = index_data[i];                                      \
+                                                                        \
+    if (index_elt == NA_INTEGER || index_elt < 1 || index_elt > info.size) { \
+      p_out[i] = NA_VALUE;                                              \
+    } else {                                                            \
+      p_out[i] = p_values[rle_info_find_run(&info, index_elt - 1)];     \
+    }                                                                   \
+  }
+
+// Is `index` an increasing sequence of consecutive locations within
+// a vector of size `size`?
+static bool is_contiguous_index(const int* p_index, R_len_t n, R_len_t size) {
+  if (n == 0) {
+    return false;
+  }
+
+  int start = p_index[0];
+  if (start == NA_INTEGER || start < 1 || start > size - n + 1) {
+    return false;
+  }
+
+  for (R_len_t i = 1; i < n; ++i) {
+    if (p_index[i] != start + i) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+SEXP altrep_rle_Extract_subset(SEXP x, SEXP indx, SEXP call) {
+  // If the vector is already materialized, or with double indices,
+  // just fall back to the default implementation
+  if (R_altrep_data2(x) != R_NilValue || TYPEOF(indx) != INTSXP) {
+    return NULL;
+  }
+
+  struct rle_info info = rle_info(x);
+
+  const int* index_data = INTEGER_RO(indx);
+  R_len_t index_n = Rf_length(indx);
+
+  // Contiguous subsets stay compressed
+  if (is_contiguous_index(index_data, index_n, info.size)) {
+    return new_rle(info.values, RLE_ENDS(x), info.offset + index_data[0] - 1, index_n);
+  }
+
+  SEXP out = PROTECT(Rf_allocVector(TYPEOF(x), index_n));
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: { RLE_EXTRACT_SUBSET(int, LOGICAL_RO, LOGICAL, NA_LOGICAL); break; }
+  case INTSXP: { RLE_EXTRACT_SUBSET(int, INTEGER_RO, INTEGER, NA_INTEGER); break; }
+  case REALSXP: { RLE_EXTRACT_SUBSET(double, REAL_RO, REAL, NA_REAL); break; }
+  case STRSXP: {
+    for (R_len_t i = 0; i < index_n; ++i) {
+      int index_elt = index_data[i];
+
+      if (index_elt == NA_INTEGER || index_elt < 1 || index_elt > info.size) {
+        SET_STRING_ELT(out, i, NA_STRING);
+      } else {
+        SET_STRING_ELT(out, i, STRING_ELT(info.values, rle_info_find_run(&info, index_elt - 1)));
+      }
+    }
+    break;
+  }
+  default: Rf_error("Internal error: Unexpected type in `altrep_rle_Extract_subset()`.");
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+#undef RLE_EXTRACT_SUBSET
+
+// Element access -------------------
+
+#define RLE_ELT(CONST_DEREF)                                    \
+  SEXP data2 = R_altrep_data2(vec);                             \
+  if (data2 != R_NilValue) {                                    \
+    return CONST_DEREF(data2)[i];                               \
+  }                                                             \
+                                                                \
+  struct rle_info info = rle_info(vec);                         \
+  return CONST_DEREF(info.values)[rle_info_find_run(&info, i)]
 
-// the element at the index `i`
 SEXP altrep_rle_string_Elt(SEXP vec, R_xlen_t i) {
   SEXP data2 = R_altrep_data2(vec);
   if (data2 != R_NilValue) {
     return STRING_ELT(data2, i);
   }
 
-  SEXP rle = R_altrep_data1(vec);
-  int* rle_p = INTEGER(rle);
-  SEXP nms = Rf_getAttrib(rle, Rf_install("names"));
+  struct rle_info info = rle_info(vec);
+  return STRING_ELT(info.values, rle_info_find_run(&info, i));
+}
+
+static int altrep_rle_int_Elt(SEXP vec, R_xlen_t i) {
+  RLE_ELT(INTEGER_RO);
+}
+static double altrep_rle_dbl_Elt(SEXP vec, R_xlen_t i) {
+  RLE_ELT(REAL_RO);
+}
+#if (R_VERSION >= R_Version(3, 6, 0))
+static int altrep_rle_lgl_Elt(SEXP vec, R_xlen_t i) {
+  RLE_ELT(LOGICAL_RO);
+}
+#endif
+
+#undef RLE_ELT
+
+// Fill `buf` with the elements `[i, i + n)`, one run at a time
+#define RLE_GET_REGION(CTYPE, CONST_DEREF, GET_REGION)                  \
+  SEXP data2 = R_altrep_data2(vec);                                     \
+  if (data2 != R_NilValue) {                                            \
+    return GET_REGION(data2, i, n, buf);                                \
+  }                                                                     \
+                                                                        \
+  struct rle_info info = rle_info(vec);                                 \
+  if (i >= info.size) {                                                 \
+    return 0;                                                           \
+  }                                                                     \
+  n = (n < info.size - i) ? n : info.size - i;                          \
+                                                                        \
+  const CTYPE* p_values = CONST_DEREF(info.values);                     \
+                                                                        \
+  R_len_t run = rle_info_find_run(&info, i);                            \
+  R_xlen_t end = i + n;                                                 \
+                                                                        \
+  for (R_xlen_t j = i; j < end; ++run) {                                \
+    R_xlen_t run_end = rle_info_run_end(&info, run);                    \
+    run_end = (run_end < end) ? run_end : end;                          \
+    CTYPE value = p_values[run];                                        \
+    for (; j < run_end; ++j) {                                          \
+      *buf++ = value;                                                   \
+    }                                                                   \
+  }                                                                     \
+                                                                        \
+  return n
+
+static R_xlen_t altrep_rle_int_Get_region(SEXP vec, R_xlen_t i, R_xlen_t n, int* buf) {
+  RLE_GET_REGION(int, INTEGER_RO, INTEGER_GET_REGION);
+}
+static R_xlen_t altrep_rle_dbl_Get_region(SEXP vec, R_xlen_t i, R_xlen_t n, double* buf) {
+  RLE_GET_REGION(double, REAL_RO, REAL_GET_REGION);
+}
+#if (R_VERSION >= R_Version(3, 6, 0))
+static R_xlen_t altrep_rle_lgl_Get_region(SEXP vec, R_xlen_t i, R_xlen_t n, int* buf) {
+  RLE_GET_REGION(int, LOGICAL_RO, LOGICAL_GET_REGION);
+}
+#endif
+
+#undef RLE_GET_REGION
+
+// Summaries ------------------------
+// These work on runs rather than elements. They return `NULL`, or an
+// unknown status, to let R compute the summary when it would warn or
+// overflow, or when the vector is materialized.
 
-  R_xlen_t idx = 0;
-  while (i >= 0 && idx < Rf_xlength(rle)) {
-    i -= rle_p[idx++];
+static int altrep_rle_No_NA(SEXP vec) {
+  if (R_altrep_data2(vec) != R_NilValue) {
+    return 0;
   }
 
-  return STRING_ELT(nms, idx - 1);
+  struct rle_info info = rle_info(vec);
+  SEXP values = info.values;
+
+  switch (TYPEOF(values)) {
+  case LGLSXP:
+  case INTSXP: {
+    const int* p_values = (TYPEOF(values) == LGLSXP) ? LOGICAL_RO(values) : INTEGER_RO(values);
+    for (R_len_t run = info.first; run < info.last; ++run) {
+      if (p_values[run] == NA_INTEGER) return 0;
+    }
+    return 1;
+  }
+  case REALSXP: {
+    const double* p_values = REAL_RO(values);
+    for (R_len_t run = info.first; run < info.last; ++run) {
+      if (isnan(p_values[run])) return 0;
+    }
+    return 1;
+  }
+  case STRSXP: {
+    const SEXP* p_values = STRING_PTR_RO(values);
+    for (R_len_t run = info.first; run < info.last; ++run) {
+      if (p_values[run] == NA_STRING) return 0;
+    }
+    return 1;
+  }
+  default:
+    return 0;
+  }
 }
 
-R_xlen_t find_rle_index(int* rle_data, R_xlen_t i, R_xlen_t size) {
-  R_xlen_t idx = 0;
-  while (i >= 0 && idx < size) {
-    i -= rle_data[idx++];
+// Runs are sorted if their values are. Only vectors without missing
+// values are reported as sorted.
+#define RLE_IS_SORTED(CTYPE, CONST_DEREF, IS_NA)                        \
+  const CTYPE* p_values = CONST_DEREF(info.values);                     \
+                                                                        \
+  for (R_len_t run = info.first; run < info.last; ++run) {              \
+    CTYPE value = p_values[run];                                        \
+                                                                        \
+    if (IS_NA(value)) {                                                 \
+      return UNKNOWN_SORTEDNESS;                                        \
+    }                                                                   \
+    if (run == info.first) {                                            \
+      continue;                                                         \
+    }                                                                   \
+                                                                        \
+    CTYPE prev = p_values[run - 1];                                     \
+    int cmp = (value > prev) - (value < prev);                          \
+                                                                        \
+    if (cmp == 0) {                                                     \
+      continue;                                                         \
+    }                                                                   \
+    if (direction == 0) {                                               \
+      direction = cmp;                                                  \
+    } else if (cmp != direction) {                                      \
+      return KNOWN_UNSORTED;                                            \
+    }                                                                   \
   }
-  return idx - 1;
+
+#define INT_IS_NA(value) (value == NA_INTEGER)
+#define DBL_IS_NA(value) isnan(value)
+
+static int altrep_rle_Is_sorted(SEXP vec) {
+  if (R_altrep_data2(vec) != R_NilValue) {
+    return UNKNOWN_SORTEDNESS;
+  }
+
+  struct rle_info info = rle_info(vec);
+  int direction = 0;
+
+  switch (TYPEOF(vec)) {
+  case LGLSXP: { RLE_IS_SORTED(int, LOGICAL_RO, INT_IS_NA); break; }
+  case INTSXP: { RLE_IS_SORTED(int, INTEGER_RO, INT_IS_NA); break; }
+  case REALSXP: { RLE_IS_SORTED(double, REAL_RO, DBL_IS_NA); break; }
+  default: return UNKNOWN_SORTEDNESS;
+  }
+
+  return (direction < 0) ? SORTED_DECR : SORTED_INCR;
 }
 
+#undef INT_IS_NA
+#undef DBL_IS_NA
+#undef RLE_IS_SORTED
 
-// This is a simple implementation, a more complex one would produce a
-// altrep_rle object as well
-SEXP altrep_rle_Extract_subset(SEXP x, SEXP indx, SEXP call) {
-  SEXP data2 = R_altrep_data2(x);
-  // If the vector is already materialized, just fall back to the default
-  // implementation
-  if (data2 != R_NilValue) {
+static SEXP altrep_rle_int_Sum(SEXP vec, Rboolean narm) {
+  if (R_altrep_data2(vec) != R_NilValue) {
     return NULL;
   }
 
-  SEXP data1 = R_altrep_data1(x);
+  struct rle_info info = rle_info(vec);
+  const int* p_values = INTEGER_RO(info.values);
 
-  int* index_data = INTEGER(indx);
-  R_xlen_t index_n = Rf_length(indx);
+  int64_t sum = 0;
+  R_len_t start = 0;
 
-  int* rle_data = INTEGER(data1);
-  R_xlen_t rle_n = Rf_length(data1);
+  for (R_len_t run = info.first; run < info.last; ++run) {
+    int value = p_values[run];
+    R_len_t end = rle_info_run_end(&info, run);
+    R_len_t length = end - start;
+    start = end;
 
-  SEXP nms = PROTECT(Rf_getAttrib(data1, Rf_install("names")));
-  SEXP out = PROTECT(Rf_allocVector(STRSXP, index_n));
+    if (value == NA_INTEGER) {
+      if (narm) {
+        continue;
+      }
+      return Rf_ScalarInteger(NA_INTEGER);
+    }
 
-  for (R_len_t i = 0; i < index_n; ++i) {
-    int index_elt = index_data[i];
+    // Can't overflow as `value` and `length` are 32 bits integers
+    sum += (int64_t) value * length;
 
-    if (index_elt == NA_INTEGER) {
-      SET_STRING_ELT(out, i, NA_STRING);
-      continue;
+    if (sum > INT_MAX || sum <= INT_MIN) {
+      return NULL;
     }
+  }
 
-    --index_elt;
+  return Rf_ScalarInteger((int) sum);
+}
 
-    R_xlen_t rle_idx = find_rle_index(rle_data, index_elt, rle_n);
-    SET_STRING_ELT(out, i, STRING_ELT(nms, rle_idx));
+static SEXP altrep_rle_dbl_Sum(SEXP vec, Rboolean narm) {
+  if (R_altrep_data2(vec) != R_NilValue) {
+    return NULL;
   }
 
-  UNPROTECT(2);
-  return out;
+  struct rle_info info = rle_info(vec);
+  const double* p_values = REAL_RO(info.values);
+
+  long double sum = 0;
+  R_len_t start = 0;
+
+  for (R_len_t run = info.first; run < info.last; ++run) {
+    double value = p_values[run];
+    R_len_t end = rle_info_run_end(&info, run);
+    R_len_t length = end - start;
+    start = end;
+
+    if (narm && isnan(value)) {
+      continue;
+    }
+
+    sum += (long double) value * length;
+  }
+
+  return Rf_ScalarReal((double) sum);
 }
 
-// --- Altvec
-SEXP altrep_rle_string_Materialize(SEXP vec) {
-  SEXP data2 = R_altrep_data2(vec);
-  if (data2 != R_NilValue) {
-    return data2;
+static SEXP altrep_rle_int_extremum(SEXP vec, Rboolean narm, bool is_max) {
+  if (R_altrep_data2(vec) != R_NilValue) {
+    return NULL;
   }
 
-  R_xlen_t sz = altrep_rle_Length(vec);
-  SEXP rle = R_altrep_data1(vec);
-  int* rle_p = INTEGER(rle);
+  struct rle_info info = rle_info(vec);
+  const int* p_values = INTEGER_RO(info.values);
 
-  SEXP out = PROTECT(Rf_allocVector(STRSXP, sz));
+  bool seen = false;
+  int out = 0;
 
-  R_xlen_t idx = 0;
-  SEXP nms = Rf_getAttrib(rle, Rf_install("names"));
-  for (R_xlen_t i = 0; i < Rf_xlength(rle); ++i) {
-    for (R_xlen_t j = 0; j < rle_p[i]; ++j) {
-      SET_STRING_ELT(out, idx++, STRING_ELT(nms, i));
+  for (R_len_t run = info.first; run < info.last; ++run) {
+    int value = p_values[run];
+
+    if (value == NA_INTEGER) {
+      if (narm) {
+        continue;
+      }
+      return Rf_ScalarInteger(NA_INTEGER);
+    }
+
+    if (!seen || (is_max ? value > out : value < out)) {
+      out = value;
+      seen = true;
     }
   }
 
-  UNPROTECT(1);
-  R_set_altrep_data2(vec, out);
+  // R warns and returns an infinite value for empty inputs
+  if (!seen) {
+    return NULL;
+  }
 
-  return out;
+  return Rf_ScalarInteger(out);
 }
 
-void* altrep_rle_Dataptr(SEXP vec, Rboolean writeable) {
-  return STDVEC_DATAPTR(altrep_rle_string_Materialize(vec));
-}
+static SEXP altrep_rle_dbl_extremum(SEXP vec, Rboolean narm, bool is_max) {
+  if (R_altrep_data2(vec) != R_NilValue) {
+    return NULL;
+  }
 
-const void* altrep_rle_Dataptr_or_null(SEXP vec) {
-  SEXP data2 = R_altrep_data2(vec);
-  if (data2 == R_NilValue)
+  struct rle_info info = rle_info(vec);
+  const double* p_values = REAL_RO(info.values);
+
+  bool seen = false;
+  double out = 0;
+
+  for (R_len_t run = info.first; run < info.last; ++run) {
+    double value = p_values[run];
+
+    if (isnan(value)) {
+      if (narm) {
+        continue;
+      }
+      // R decides between `NA` and `NaN`
+      return NULL;
+    }
+
+    if (!seen || (is_max ? value > out : value < out)) {
+      out = value;
+      seen = true;
+    }
+  }
+
+  if (!seen) {
     return NULL;
+  }
 
-  return STDVEC_DATAPTR(data2);
+  return Rf_ScalarReal(out);
 }
 
+static SEXP altrep_rle_int_Min(SEXP vec, Rboolean narm) {
+  return altrep_rle_int_extremum(vec, narm, false);
+}
+static SEXP altrep_rle_int_Max(SEXP vec, Rboolean narm) {
+  return altrep_rle_int_extremum(vec, narm, true);
+}
+static SEXP altrep_rle_dbl_Min(SEXP vec, Rboolean narm) {
+  return altrep_rle_dbl_extremum(vec, narm, false);
+}
+static SEXP altrep_rle_dbl_Max(SEXP vec, Rboolean narm) {
+  return altrep_rle_dbl_extremum(vec, narm, true);
+}
 
-void vctrs_init_altrep_rle(DllInfo* dll) {
-  altrep_rle_class = R_make_altstring_class("altrep_rle", "vctrs", dll);
 
+static void init_altrep_rle_class(R_altrep_class_t cls) {
   // altrep
-  R_set_altrep_Length_method(altrep_rle_class, altrep_rle_Length);
-  R_set_altrep_Inspect_method(altrep_rle_class, altrep_rle_Inspect);
+  R_set_altrep_Length_method(cls, altrep_rle_Length);
+  R_set_altrep_Inspect_method(cls, altrep_rle_Inspect);
+  R_set_altrep_Duplicate_method(cls, altrep_rle_Duplicate);
+  R_set_altrep_Serialized_state_method(cls, altrep_rle_Serialized_state);
+  R_set_altrep_Unserialize_method(cls, altrep_rle_Unserialize);
 
   // altvec
-  R_set_altvec_Dataptr_method(altrep_rle_class, altrep_rle_Dataptr);
-  R_set_altvec_Dataptr_or_null_method(altrep_rle_class, altrep_rle_Dataptr_or_null);
-  R_set_altvec_Extract_subset_method(altrep_rle_class, altrep_rle_Extract_subset);
+  R_set_altvec_Dataptr_method(cls, altrep_rle_Dataptr);
+  R_set_altvec_Dataptr_or_null_method(cls, altrep_rle_Dataptr_or_null);
+  R_set_altvec_Extract_subset_method(cls, altrep_rle_Extract_subset);
+}
+
+void vctrs_init_altrep_rle(DllInfo* dll) {
+  altrep_rle_class = R_make_altstring_class("altrep_rle", "vctrs", dll);
+  init_altrep_rle_class(altrep_rle_class);
 
-  // altstring
   R_set_altstring_Elt_method(altrep_rle_class, altrep_rle_string_Elt);
+  R_set_altstring_No_NA_method(altrep_rle_class, altrep_rle_No_NA);
+
+  altrep_rle_int_class = R_make_altinteger_class("altrep_rle_int", "vctrs", dll);
+  init_altrep_rle_class(altrep_rle_int_class);
+
+  R_set_altinteger_Elt_method(altrep_rle_int_class, altrep_rle_int_Elt);
+  R_set_altinteger_Get_region_method(altrep_rle_int_class, altrep_rle_int_Get_region);
+  R_set_altinteger_Is_sorted_method(altrep_rle_int_class, altrep_rle_Is_sorted);
+  R_set_altinteger_No_NA_method(altrep_rle_int_class, altrep_rle_No_NA);
+  R_set_altinteger_Sum_method(altrep_rle_int_class, altrep_rle_int_Sum);
+  R_set_altinteger_Min_method(altrep_rle_int_class, altrep_rle_int_Min);
+  R_set_altinteger_Max_method(altrep_rle_int_class, altrep_rle_int_Max);
+
+  altrep_rle_dbl_class = R_make_altreal_class("altrep_rle_dbl", "vctrs", dll);
+  init_altrep_rle_class(altrep_rle_dbl_class);
+
+  R_set_altreal_Elt_method(altrep_rle_dbl_class, altrep_rle_dbl_Elt);
+  R_set_altreal_Get_region_method(altrep_rle_dbl_class, altrep_rle_dbl_Get_region);
+  R_set_altreal_Is_sorted_method(altrep_rle_dbl_class, altrep_rle_Is_sorted);
+  R_set_altreal_No_NA_method(altrep_rle_dbl_class, altrep_rle_No_NA);
+  R_set_altreal_Sum_method(altrep_rle_dbl_class, altrep_rle_dbl_Sum);
+  R_set_altreal_Min_method(altrep_rle_dbl_class, altrep_rle_dbl_Min);
+  R_set_altreal_Max_method(altrep_rle_dbl_class, altrep_rle_dbl_Max);
+
+  // Logical ALTREP classes are available from R 3.6
+#if (R_VERSION >= R_Version(3, 6, 0))
+  altrep_rle_lgl_class = R_make_altlogical_class("altrep_rle_lgl", "vctrs", dll);
+  init_altrep_rle_class(altrep_rle_lgl_class);
+
+  R_set_altlogical_Elt_method(altrep_rle_lgl_class, altrep_rle_lgl_Elt);
+  R_set_altlogical_Get_region_method(altrep_rle_lgl_class, altrep_rle_lgl_Get_region);
+  R_set_altlogical_Is_sorted_method(altrep_rle_lgl_class, altrep_rle_Is_sorted);
+  R_set_altlogical_No_NA_method(altrep_rle_lgl_class, altrep_rle_No_NA);
+#endif
 }
 
 #endif // R version >= 3.5.0
@@ -3,9 +3,13 @@
 
 #include "altrep.h"
 
+SEXP altrep_rle_slice_seq(SEXP x, R_len_t start, R_len_t size);
+SEXP altrep_rle_runs(SEXP x);
+
 #if (R_VERSION >= R_Version(3, 5, 0))
 
 SEXP altrep_rle_Make(SEXP input);
+SEXP vctrs_new_rle(SEXP values, SEXP lengths);
 R_xlen_t altrep_rle_Length(SEXP vec);
 Rboolean altrep_rle_Inspect(
     SEXP x,
@@ -15,12 +19,14 @@ Rboolean altrep_rle_Inspect(
     void (*inspect_subtree)(SEXP, int, int, int));
 SEXP altrep_rle_string_Elt(SEXP vec, R_xlen_t i);
 SEXP altrep_rle_Extract_subset(SEXP x, SEXP indx, SEXP call);
-SEXP altrep_rle_string_Materialize(SEXP vec);
 void* altrep_rle_Dataptr(SEXP vec, Rboolean writeable);
 const void* altrep_rle_Dataptr_or_null(SEXP vec);
 void vctrs_init_altrep_rle(DllInfo* dll);
 
 extern R_altrep_class_t altrep_rle_class;
+extern R_altrep_class_t altrep_rle_int_class;
+extern R_altrep_class_t altrep_rle_dbl_class;
+extern R_altrep_class_t altrep_rle_lgl_class;
 
 #endif
 
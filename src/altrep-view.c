@@ -0,0 +1,328 @@
+#include "vctrs.h"
+#include "altrep-view.h"
+#include "altrep.h"
+
+// Views rely on reference counting to protect their parent from
+// modification, which is available from R 4.0
+#if (R_VERSION < R_Version(4, 0, 0))
+
+void vctrs_init_altrep_view(DllInfo* dll) { }
+
+SEXP altrep_view_slice(SEXP x, R_len_t start, R_len_t size) {
+  return NULL;
+}
+
+#else
+
+
+// Initialised at load time
+R_altrep_class_t altrep_view_lgl_class;
+R_altrep_class_t altrep_view_int_class;
+R_altrep_class_t altrep_view_dbl_class;
+R_altrep_class_t altrep_view_chr_class;
+R_altrep_class_t altrep_view_raw_class;
+
+// Views are contiguous slices that reference their parent vector
+// instead of copying it. They store the parent and a `window` of an
+// offset and a size in `data1`. Reading through `DATAPTR_RO()` or
+// `DATAPTR_OR_NULL()` points into the parent. Writing through
+// `DATAPTR()` copies the window into `data2`, which is used from then
+// on, and releases the parent. The reference held in `data1` makes R
+// copy the parent before modifying it.
+
+#define VIEW_PARENT(x) VECTOR_ELT(R_altrep_data1(x), 0)
+#define VIEW_OFFSET(x) INTEGER_RO(VECTOR_ELT(R_altrep_data1(x), 1))[0]
+#define VIEW_SIZE(x) INTEGER_RO(VECTOR_ELT(R_altrep_data1(x), 1))[1]
+
+// Smaller slices are copied, which is cheaper than allocating a view.
+// Views must also cover at least half of their parent since they keep
+// all of it alive.
+#define VIEW_MIN_SIZE 1024
+#define VIEW_MIN_FRACTION 2
+
+static bool view_class(SEXPTYPE type, R_altrep_class_t* p_class) {
+  switch (type) {
+  case INTSXP: *p_class = altrep_view_int_class; return true;
+  case REALSXP: *p_class = altrep_view_dbl_class; return true;
+  case STRSXP: *p_class = altrep_view_chr_class; return true;
+  case LGLSXP: *p_class = altrep_view_lgl_class; return true;
+  case RAWSXP: *p_class = altrep_view_raw_class; return true;
+  default: return false;
+  }
+}
+
+static SEXP new_view(R_altrep_class_t cls, SEXP parent, R_len_t offset, R_len_t size) {
+  SEXP data1 = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(data1, 0, parent);
+
+  SEXP window = Rf_allocVector(INTSXP, 2);
+  SET_VECTOR_ELT(data1, 1, window);
+  INTEGER(window)[0] = offset;
+  INTEGER(window)[1] = size;
+
+  SEXP out = R_new_altrep(cls, data1, R_NilValue);
+
+  UNPROTECT(1);
+  return out;
+}
+
+/**
+ * Slice an atomic vector with a contiguous sequence, without copying
+ *
+ * @param start The 0-based location of the first element.
+ * @param size The size of the slice.
+ * @return A view of `x`, or `NULL` if `x` can't be viewed. Small
+ *   slices, slices of less than half of the parent, ALTREP vectors
+ *   other than views, and materialized views are not viewed.
+ */
+SEXP altrep_view_slice(SEXP x, R_len_t start, R_len_t size) {
+  R_altrep_class_t cls;
+
+  if (size < VIEW_MIN_SIZE || !view_class(TYPEOF(x), &cls)) {
+    return NULL;
+  }
+
+  // Views of views reference the original parent
+  if (ALTREP(x)) {
+    if (!R_altrep_inherits(x, cls) || R_altrep_data2(x) != R_NilValue) {
+      return NULL;
+    }
+    start += VIEW_OFFSET(x);
+    x = VIEW_PARENT(x);
+  }
+
+  if ((R_xlen_t) size * VIEW_MIN_FRACTION < Rf_xlength(x)) {
+    return NULL;
+  }
+
+  return new_view(cls, x, start, size);
+}
+
+static SEXP altrep_view_Materialize(SEXP x) {
+  SEXP data2 = R_altrep_data2(x);
+  if (data2 != R_NilValue) {
+    return data2;
+  }
+
+  SEXP parent = VIEW_PARENT(x);
+  R_len_t offset = VIEW_OFFSET(x);
+  R_len_t size = VIEW_SIZE(x);
+
+  SEXP out = PROTECT(Rf_allocVector(TYPEOF(x), size));
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: memcpy(LOGICAL(out), LOGICAL_RO(parent) + offset, size * sizeof(int)); break;
+  case INTSXP: memcpy(INTEGER(out), INTEGER_RO(parent) + offset, size * sizeof(int)); break;
+  case REALSXP: memcpy(REAL(out), REAL_RO(parent) + offset, size * sizeof(double)); break;
+  case RAWSXP: memcpy(RAW(out), RAW_RO(parent) + offset, size * sizeof(Rbyte)); break;
+  case STRSXP: {
+    const SEXP* p_parent = STRING_PTR_RO(parent) + offset;
+    for (R_len_t i = 0; i < size; ++i) {
+      SET_STRING_ELT(out, i, p_parent[i]);
+    }
+    break;
+  }
+  default: Rf_error("Internal error: Unexpected type in `altrep_view_Materialize()`.");
+  }
+
+  R_set_altrep_data2(x, out);
+
+  // Only the window is needed from now on. `data1` might be shared with
+  // duplicates of `x`, so it is replaced rather than modified.
+  SEXP data1 = Rf_allocVector(VECSXP, 2);
+  SET_VECTOR_ELT(data1, 1, VECTOR_ELT(R_altrep_data1(x), 1));
+  R_set_altrep_data1(x, data1);
+
+  UNPROTECT(1);
+  return out;
+}
+
+static const void* view_parent_dataptr(SEXP x) {
+  SEXP parent = VIEW_PARENT(x);
+  R_len_t offset = VIEW_OFFSET(x);
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: return LOGICAL_RO(parent) + offset;
+  case INTSXP: return INTEGER_RO(parent) + offset;
+  case REALSXP: return REAL_RO(parent) + offset;
+  case RAWSXP: return RAW_RO(parent) + offset;
+  case STRSXP: return STRING_PTR_RO(parent) + offset;
+  default: Rf_error("Internal error: Unexpected type in `view_parent_dataptr()`.");
+  }
+}
+
+// ALTREP methods -------------------
+
+static R_xlen_t altrep_view_Length(SEXP x) {
+  return VIEW_SIZE(x);
+}
+
+static Rboolean altrep_view_Inspect(SEXP x,
+                                    int pre,
+                                    int deep,
+                                    int pvec,
+                                    void (*inspect_subtree)(SEXP, int, int, int)) {
+  Rprintf("vctrs_view %s (len=%d, offset=%d, materialized=%s)\n",
+          Rf_type2char(TYPEOF(x)),
+          VIEW_SIZE(x),
+          VIEW_OFFSET(x),
+          R_altrep_data2(x) != R_NilValue ? "T" : "F");
+  return TRUE;
+}
+
+// Duplicates share the parent until they are written to
+static SEXP altrep_view_Duplicate(SEXP x, Rboolean deep) {
+  if (R_altrep_data2(x) != R_NilValue) {
+    return NULL;
+  }
+
+  R_altrep_class_t cls;
+  view_class(TYPEOF(x), &cls);
+
+  return R_new_altrep(cls, R_altrep_data1(x), R_NilValue);
+}
+
+// ALTVEC methods -------------------
+
+static void* altrep_view_Dataptr(SEXP x, Rboolean writeable) {
+  SEXP data2 = R_altrep_data2(x);
+  if (data2 != R_NilValue) {
+    return STDVEC_DATAPTR(data2);
+  }
+
+  // Read-only access doesn't need a copy
+  if (!writeable) {
+    return (void*) view_parent_dataptr(x);
+  }
+
+  return STDVEC_DATAPTR(altrep_view_Materialize(x));
+}
+
+static const void* altrep_view_Dataptr_or_null(SEXP x) {
+  SEXP data2 = R_altrep_data2(x);
+  if (data2 != R_NilValue) {
+    return STDVEC_DATAPTR(data2);
+  }
+
+  return view_parent_dataptr(x);
+}
+
+// Element access -------------------
+
+#define VIEW_ELT(CONST_DEREF)                                   \
+  SEXP data2 = R_altrep_data2(x);                               \
+  if (data2 != R_NilValue) {                                    \
+    return CONST_DEREF(data2)[i];                               \
+  }                                                             \
+  return CONST_DEREF(VIEW_PARENT(x))[VIEW_OFFSET(x) + i]
+
+static int altrep_view_int_Elt(SEXP x, R_xlen_t i) {
+  VIEW_ELT(INTEGER_RO);
+}
+static double altrep_view_dbl_Elt(SEXP x, R_xlen_t i) {
+  VIEW_ELT(REAL_RO);
+}
+static int altrep_view_lgl_Elt(SEXP x, R_xlen_t i) {
+  VIEW_ELT(LOGICAL_RO);
+}
+static Rbyte altrep_view_raw_Elt(SEXP x, R_xlen_t i) {
+  VIEW_ELT(RAW_RO);
+}
+
+#undef VIEW_ELT
+
+static SEXP altrep_view_chr_Elt(SEXP x, R_xlen_t i) {
+  SEXP data2 = R_altrep_data2(x);
+  if (data2 != R_NilValue) {
+    return STRING_ELT(data2, i);
+  }
+  return STRING_ELT(VIEW_PARENT(x), VIEW_OFFSET(x) + i);
+}
+
+static void altrep_view_chr_Set_elt(SEXP x, R_xlen_t i, SEXP value) {
+  SET_STRING_ELT(altrep_view_Materialize(x), i, value);
+}
+
+// Metadata -------------------------
+// A view is sorted, or free of missing values, if its parent is. The
+// parent metadata no longer applies once the view is materialized.
+
+static int altrep_view_No_NA(SEXP x) {
+  if (R_altrep_data2(x) != R_NilValue) {
+    return 0;
+  }
+
+  SEXP parent = VIEW_PARENT(x);
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: return LOGICAL_NO_NA(parent);
+  case INTSXP: return INTEGER_NO_NA(parent);
+  case REALSXP: return REAL_NO_NA(parent);
+  case STRSXP: return STRING_NO_NA(parent);
+  default: return 0;
+  }
+}
+
+static int altrep_view_Is_sorted(SEXP x) {
+  if (R_altrep_data2(x) != R_NilValue) {
+    return UNKNOWN_SORTEDNESS;
+  }
+
+  SEXP parent = VIEW_PARENT(x);
+  int sorted;
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: sorted = LOGICAL_IS_SORTED(parent); break;
+  case INTSXP: sorted = INTEGER_IS_SORTED(parent); break;
+  case REALSXP: sorted = REAL_IS_SORTED(parent); break;
+  case STRSXP: sorted = STRING_IS_SORTED(parent); break;
+  default: return UNKNOWN_SORTEDNESS;
+  }
+
+  return KNOWN_SORTED(sorted) ? sorted : UNKNOWN_SORTEDNESS;
+}
+
+
+static void init_altrep_view_class(R_altrep_class_t cls) {
+  // altrep
+  R_set_altrep_Length_method(cls, altrep_view_Length);
+  R_set_altrep_Inspect_method(cls, altrep_view_Inspect);
+  R_set_altrep_Duplicate_method(cls, altrep_view_Duplicate);
+
+  // altvec
+  R_set_altvec_Dataptr_method(cls, altrep_view_Dataptr);
+  R_set_altvec_Dataptr_or_null_method(cls, altrep_view_Dataptr_or_null);
+}
+
+void vctrs_init_altrep_view(DllInfo* dll) {
+  altrep_view_int_class = R_make_altinteger_class("altrep_view_int", "vctrs", dll);
+  init_altrep_view_class(altrep_view_int_class);
+  R_set_altinteger_Elt_method(altrep_view_int_class, altrep_view_int_Elt);
+  R_set_altinteger_Is_sorted_method(altrep_view_int_class, altrep_view_Is_sorted);
+  R_set_altinteger_No_NA_method(altrep_view_int_class, altrep_view_No_NA);
+
+  altrep_view_dbl_class = R_make_altreal_class("altrep_view_dbl", "vctrs", dll);
+  init_altrep_view_class(altrep_view_dbl_class);
+  R_set_altreal_Elt_method(altrep_view_dbl_class, altrep_view_dbl_Elt);
+  R_set_altreal_Is_sorted_method(altrep_view_dbl_class, altrep_view_Is_sorted);
+  R_set_altreal_No_NA_method(altrep_view_dbl_class, altrep_view_No_NA);
+
+  altrep_view_chr_class = R_make_altstring_class("altrep_view_chr", "vctrs", dll);
+  init_altrep_view_class(altrep_view_chr_class);
+  R_set_altstring_Elt_method(altrep_view_chr_class, altrep_view_chr_Elt);
+  R_set_altstring_Set_elt_method(altrep_view_chr_class, altrep_view_chr_Set_elt);
+  R_set_altstring_Is_sorted_method(altrep_view_chr_class, altrep_view_Is_sorted);
+  R_set_altstring_No_NA_method(altrep_view_chr_class, altrep_view_No_NA);
+
+  altrep_view_lgl_class = R_make_altlogical_class("altrep_view_lgl", "vctrs", dll);
+  init_altrep_view_class(altrep_view_lgl_class);
+  R_set_altlogical_Elt_method(altrep_view_lgl_class, altrep_view_lgl_Elt);
+  R_set_altlogical_Is_sorted_method(altrep_view_lgl_class, altrep_view_Is_sorted);
+  R_set_altlogical_No_NA_method(altrep_view_lgl_class, altrep_view_No_NA);
+
+  altrep_view_raw_class = R_make_altraw_class("altrep_view_raw", "vctrs", dll);
+  init_altrep_view_class(altrep_view_raw_class);
+  R_set_altraw_Elt_method(altrep_view_raw_class, altrep_view_raw_Elt);
+}
+
+#endif // R version >= 4.0.0
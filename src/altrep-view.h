@@ -0,0 +1,10 @@
+#ifndef ALTREP_VIEW_H
+#define ALTREP_VIEW_H
+
+#include "altrep.h"
+#include <R_ext/Rdynload.h>
+
+SEXP altrep_view_slice(SEXP x, R_len_t start, R_len_t size);
+void vctrs_init_altrep_view(DllInfo* dll);
+
+#endif
@@ -36,9 +36,7 @@ static int scmp(SEXP x, SEXP y) {
     return cmp / abs(cmp);
   }
 
-  const void *vmax = vmaxget();
-  int cmp = strcmp(Rf_translateCharUTF8(x), Rf_translateCharUTF8(y));
-  vmaxset(vmax);
+  int cmp = strcmp(CHAR(str_translate_utf8(x)), CHAR(str_translate_utf8(y)));
 
   if (cmp == 0) {
     return cmp;
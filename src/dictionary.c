@@ -1,4 +1,5 @@
 #include "vctrs.h"
+#include "altrep-rle.h"
 #include "dictionary.h"
 #include "utils.h"
 
@@ -92,6 +93,14 @@ uint32_t dict_hash_with(struct dictionary* d, struct dictionary* x, R_len_t i) {
       return probe;
     }
 
+    // Equal values have equal hashes, so values with different hashes
+    // can be skipped without a potentially deep comparison. This
+    // matters for lists of nested objects, whose equality is
+    // determined recursively.
+    if (d->hash[idx] != hash) {
+      continue;
+    }
+
     // Check for same value as there might be a collision. If there is
     // a collision, next iteration will find another spot using
     // quadratic probing.
@@ -117,14 +126,30 @@ void dict_put(struct dictionary* d, uint32_t hash, R_len_t i) {
 // TODO: rename to match R function names
 // TODO: separate out into individual files
 
+static SEXP unique_loc_rle(SEXP runs);
+static SEXP unique_loc_runs(SEXP x, R_len_t n);
+
 SEXP vctrs_unique_loc(SEXP x) {
   int nprot = 0;
 
+  SEXP runs = PROTECT_N(altrep_rle_runs(x), &nprot);
+  if (runs != R_NilValue) {
+    SEXP out = unique_loc_rle(runs);
+    UNPROTECT(nprot);
+    return out;
+  }
+
   R_len_t n = vec_size(x);
 
   x = PROTECT_N(vec_proxy_equal(x), &nprot);
   x = PROTECT_N(obj_maybe_translate_encoding(x, n), &nprot);
 
+  if (proxy_is_monotonic(x, n)) {
+    SEXP out = unique_loc_runs(x, n);
+    UNPROTECT(nprot);
+    return out;
+  }
+
   struct dictionary d;
   dict_init(&d, x);
   PROTECT_DICT(&d, &nprot);
@@ -147,10 +172,56 @@ SEXP vctrs_unique_loc(SEXP x) {
   return out;
 }
 
+// The unique values of a run length encoded vector are found among its
+// run values. Their locations are the starts of their first runs.
+static SEXP unique_loc_rle(SEXP runs) {
+  SEXP values = VECTOR_ELT(runs, 0);
+  const int* p_lengths = INTEGER_RO(VECTOR_ELT(runs, 1));
+  R_len_t n_runs = Rf_length(values);
+
+  int* p_starts = (int*) R_alloc(n_runs, sizeof(int));
+  R_len_t start = 0;
+
+  for (R_len_t i = 0; i < n_runs; ++i) {
+    p_starts[i] = start;
+    start += p_lengths[i];
+  }
+
+  SEXP out = PROTECT(vctrs_unique_loc(values));
+  int* p_out = INTEGER(out);
+  R_len_t n_out = Rf_length(out);
+
+  for (R_len_t i = 0; i < n_out; ++i) {
+    p_out[i] = p_starts[p_out[i] - 1] + 1;
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// The unique values of a monotonic proxy are the heads of its runs
+static SEXP unique_loc_runs(SEXP x, R_len_t n) {
+  int nprot = 0;
+
+  struct growable g = new_growable(INTSXP, 256);
+  PROTECT_GROWABLE(&g, &nprot);
+
+  for (R_len_t i = 0; i < n; ++i) {
+    if (i == 0 || !equal_scalar(x, i - 1, x, i, true)) {
+      growable_push_int(&g, i + 1);
+    }
+  }
+
+  SEXP out = growable_values(&g);
+
+  UNPROTECT(nprot);
+  return out;
+}
+
 // [[ include("vctrs.h") ]]
 SEXP vec_unique(SEXP x) {
   SEXP index = PROTECT(vctrs_unique_loc(x));
-  SEXP out = vec_slice(x, index);
+  SEXP out = vec_slice_trusted(x, index);
   UNPROTECT(1);
   return out;
 }
@@ -343,14 +414,31 @@ SEXP vctrs_in(SEXP needles, SEXP haystack) {
   return out;
 }
 
+static SEXP new_count(SEXP key, SEXP val);
+static SEXP count_rle(SEXP runs);
+static SEXP count_runs(SEXP x, R_len_t n);
+
 SEXP vctrs_count(SEXP x) {
   int nprot = 0;
 
+  SEXP runs = PROTECT_N(altrep_rle_runs(x), &nprot);
+  if (runs != R_NilValue) {
+    SEXP out = count_rle(runs);
+    UNPROTECT(nprot);
+    return out;
+  }
+
   R_len_t n = vec_size(x);
 
   x = PROTECT_N(vec_proxy_equal(x), &nprot);
   x = PROTECT_N(obj_maybe_translate_encoding(x, n), &nprot);
 
+  if (proxy_is_monotonic(x, n)) {
+    SEXP out = count_runs(x, n);
+    UNPROTECT(nprot);
+    return out;
+  }
+
   struct dictionary d;
   dict_init(&d, x);
   PROTECT_DICT(&d, &nprot);
@@ -384,15 +472,94 @@ SEXP vctrs_count(SEXP x) {
     i++;
   }
 
-  SEXP out = PROTECT_N(Rf_allocVector(VECSXP, 2), &nprot);
-  SET_VECTOR_ELT(out, 0, out_key);
-  SET_VECTOR_ELT(out, 1, out_val);
-  SEXP names = PROTECT_N(Rf_allocVector(STRSXP, 2), &nprot);
+  SEXP out = new_count(out_key, out_val);
+
+  UNPROTECT(nprot);
+  return out;
+}
+
+// The run values of a run length encoded vector are grouped, and the
+// run lengths are summed within groups
+static SEXP count_rle(SEXP runs) {
+  int nprot = 0;
+
+  SEXP values = VECTOR_ELT(runs, 0);
+  const int* p_lengths = INTEGER_RO(VECTOR_ELT(runs, 1));
+  R_len_t n_runs = Rf_length(values);
+
+  int* p_run_groups = (int*) R_alloc(n_runs, sizeof(int));
+  R_len_t n_groups = group_id_fill(values, n_runs, p_run_groups);
+
+  SEXP out_key = PROTECT_N(Rf_allocVector(INTSXP, n_groups), &nprot);
+  SEXP out_val = PROTECT_N(Rf_allocVector(INTSXP, n_groups), &nprot);
+  int* p_out_key = INTEGER(out_key);
+  int* p_out_val = INTEGER(out_val);
+
+  memset(p_out_val, 0, n_groups * sizeof(int));
+
+  R_len_t start = 0;
+
+  for (R_len_t i = 0; i < n_runs; ++i) {
+    int group = p_run_groups[i];
+
+    // Groups are identified in order of appearance
+    if (p_out_val[group] == 0) {
+      p_out_key[group] = start + 1;
+    }
+
+    p_out_val[group] += p_lengths[i];
+    start += p_lengths[i];
+  }
+
+  SEXP out = new_count(out_key, out_val);
+
+  UNPROTECT(nprot);
+  return out;
+}
+
+// The runs of a monotonic proxy are counted in order of appearance
+static SEXP count_runs(SEXP x, R_len_t n) {
+  int nprot = 0;
+
+  R_len_t n_runs = 0;
+  for (R_len_t i = 0; i < n; ++i) {
+    if (i == 0 || !equal_scalar(x, i - 1, x, i, true)) {
+      ++n_runs;
+    }
+  }
+
+  SEXP out_key = PROTECT_N(Rf_allocVector(INTSXP, n_runs), &nprot);
+  SEXP out_val = PROTECT_N(Rf_allocVector(INTSXP, n_runs), &nprot);
+  int* p_out_key = INTEGER(out_key);
+  int* p_out_val = INTEGER(out_val);
+
+  R_len_t run = -1;
+  for (R_len_t i = 0; i < n; ++i) {
+    if (i == 0 || !equal_scalar(x, i - 1, x, i, true)) {
+      ++run;
+      p_out_key[run] = i + 1;
+      p_out_val[run] = 0;
+    }
+    ++p_out_val[run];
+  }
+
+  SEXP out = new_count(out_key, out_val);
+
+  UNPROTECT(nprot);
+  return out;
+}
+
+static SEXP new_count(SEXP key, SEXP val) {
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(out, 0, key);
+  SET_VECTOR_ELT(out, 1, val);
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP, 2));
   SET_STRING_ELT(names, 0, Rf_mkChar("key"));
   SET_STRING_ELT(names, 1, Rf_mkChar("val"));
   Rf_setAttrib(out, R_NamesSymbol, names);
 
-  UNPROTECT(nprot);
+  UNPROTECT(2);
   return out;
 }
 
@@ -181,10 +181,7 @@ static int chr_equal_scalar_impl(const SEXP x, const SEXP y) {
   }
 
   if (Rf_getCharCE(x) != Rf_getCharCE(y)) {
-    const void *vmax = vmaxget();
-    int out = !strcmp(Rf_translateCharUTF8(x), Rf_translateCharUTF8(y));
-    vmaxset(vmax);
-    return out;
+    return !strcmp(CHAR(str_translate_utf8(x)), CHAR(str_translate_utf8(y)));
   }
 
   return 0;
@@ -352,12 +349,40 @@ bool equal_object(SEXP x, SEXP y) {
     return false;
   }
 
+  // Logical, integer and raw values are equal if and only if their
+  // bytes are equal. For doubles, complexes and strings, identical
+  // bytes imply equality but equal values might have different bytes,
+  // e.g. `0` and `-0` or strings with different encodings.
+  switch (type) {
+  case LGLSXP:  return !memcmp(LOGICAL_RO(x), LOGICAL_RO(y), n * sizeof(int));
+  case INTSXP:  return !memcmp(INTEGER_RO(x), INTEGER_RO(y), n * sizeof(int));
+  case RAWSXP:  return !memcmp(RAW_RO(x), RAW_RO(y), n);
+  case REALSXP: {
+    if (!memcmp(REAL_RO(x), REAL_RO(y), n * sizeof(double))) {
+      return true;
+    }
+    break;
+  }
+  case CPLXSXP: {
+    if (!memcmp(COMPLEX_RO(x), COMPLEX_RO(y), n * sizeof(Rcomplex))) {
+      return true;
+    }
+    break;
+  }
+  case STRSXP: {
+    if (!memcmp(STRING_PTR_RO(x), STRING_PTR_RO(y), n * sizeof(SEXP))) {
+      return true;
+    }
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+
   switch (type) {
-  case LGLSXP:  EQUAL_ALL(int, LOGICAL_RO, lgl_equal_scalar);
-  case INTSXP:  EQUAL_ALL(int, INTEGER_RO, int_equal_scalar);
   case REALSXP: EQUAL_ALL(double, REAL_RO, dbl_equal_scalar);
   case STRSXP:  EQUAL_ALL(SEXP, STRING_PTR_RO, chr_equal_scalar);
-  case RAWSXP:  EQUAL_ALL(Rbyte, RAW_RO, raw_equal_scalar);
   case CPLXSXP: EQUAL_ALL(Rcomplex, COMPLEX_RO, cpl_equal_scalar);
   case EXPRSXP:
   case VECSXP:  EQUAL_ALL_BARRIER(list_equal_scalar);
@@ -1,20 +1,17 @@
 #include "vctrs.h"
 
-// SEXP x and y must be CHARSXP
-// x_utf* is pointer to const char* which is lazily initialised:
-//  This makes this function also suitable for use when repeated
-//  comparing varying y to constant x
-bool equal_string(SEXP x, const char** x_utf8, SEXP y) {
+// SEXP x and y must be CHARSXP. UTF-8 translations are cached by
+// `str_translate_utf8()`, which makes this function suitable for
+// repeatedly comparing varying y to constant x
+bool equal_string(SEXP x, SEXP y) {
   // Try fast pointer comparison
   if (x == y)
     return true;
 
-  if (*x_utf8 == NULL)
-    *x_utf8 = Rf_translateCharUTF8(x);
-
   // Try slower conversion to common encoding
-  const char* y_utf = Rf_translateCharUTF8(y);
-  return (strcmp(y_utf, *x_utf8) == 0);
+  const char* x_utf8 = CHAR(str_translate_utf8(x));
+  const char* y_utf8 = CHAR(str_translate_utf8(y));
+  return (strcmp(y_utf8, x_utf8) == 0);
 }
 
 int find_offset(SEXP x, SEXP index) {
@@ -59,7 +56,8 @@ int find_offset(SEXP x, SEXP index) {
     if (val_0 == NA_STRING)
       Rf_errorcall(R_NilValue, "Invalid index: NA_character_");
 
-    const char* val_0_chr = Rf_translateCharUTF8(val_0);
+    SEXP val_0_utf8 = PROTECT(str_translate_utf8(val_0));
+    const char* val_0_chr = CHAR(val_0_utf8);
     if (val_0_chr[0] == '\0')
       Rf_errorcall(R_NilValue, "Invalid index: empty string");
 
@@ -68,8 +66,8 @@ int find_offset(SEXP x, SEXP index) {
       if (name_j == NA_STRING)
         Rf_errorcall(R_NilValue, "Corrupt x: element %i is unnamed", j + 1);
 
-      if (equal_string(val_0, &val_0_chr, name_j)) {
-        UNPROTECT(1);
+      if (equal_string(val_0, name_j)) {
+        UNPROTECT(2);
         return j;
       }
     }
@@ -0,0 +1,486 @@
+#include "vctrs.h"
+#include "utils.h"
+
+// Grouped summaries
+//
+// These kernels compute one summary per group in a single pass over
+// `x`, given the 1-based group identifiers returned by
+// `vec_group_id()`. Results are in group order. Missing values follow
+// the conventions of the base summary functions: they propagate
+// unless `na_rm` is true.
+
+static bool check_na_rm(SEXP na_rm);
+
+// [[ register() ]]
+SEXP vctrs_group_n(SEXP group_id, SEXP n_groups) {
+  R_len_t n = Rf_length(group_id);
+  R_len_t n_out = check_group_id(group_id, n, n_groups);
+  const int* p_group_id = INTEGER_RO(group_id);
+
+  SEXP out = PROTECT(Rf_allocVector(INTSXP, n_out));
+  int* p_out = INTEGER(out);
+  memset(p_out, 0, n_out * sizeof(int));
+
+  for (R_len_t i = 0; i < n; ++i) {
+    ++p_out[p_group_id[i] - 1];
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+static SEXP int_group_sum(const int* p_x, const int* p_group_id, R_len_t n, R_len_t n_out, bool na_rm) {
+  // Sums are accumulated in 64 bits and checked for overflow at the end
+  int64_t* p_sum = (int64_t*) R_alloc(n_out, sizeof(int64_t));
+  memset(p_sum, 0, n_out * sizeof(int64_t));
+
+  bool* p_na = (bool*) R_alloc(n_out, sizeof(bool));
+  memset(p_na, 0, n_out * sizeof(bool));
+
+  for (R_len_t i = 0; i < n; ++i) {
+    int elt = p_x[i];
+    R_len_t g = p_group_id[i] - 1;
+
+    if (elt == NA_INTEGER) {
+      p_na[g] = p_na[g] || !na_rm;
+    } else {
+      p_sum[g] += elt;
+    }
+  }
+
+  SEXP out = PROTECT(Rf_allocVector(INTSXP, n_out));
+  int* p_out = INTEGER(out);
+
+  bool overflow = false;
+
+  for (R_len_t g = 0; g < n_out; ++g) {
+    if (p_na[g]) {
+      p_out[g] = NA_INTEGER;
+      continue;
+    }
+
+    int64_t sum = p_sum[g];
+
+    // Like `sum()`, overflowing sums are missing
+    if (sum > INT_MAX || sum <= INT_MIN) {
+      p_out[g] = NA_INTEGER;
+      overflow = true;
+      continue;
+    }
+
+    p_out[g] = (int) sum;
+  }
+
+  if (overflow) {
+    Rf_warningcall(R_NilValue,
+                   "Integer overflow in `vec_group_sum()`, returning `NA`. "
+                   "Convert `x` to double first.");
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+static SEXP dbl_group_sum(const double* p_x, const int* p_group_id, R_len_t n, R_len_t n_out, bool na_rm) {
+  long double* p_sum = (long double*) R_alloc(n_out, sizeof(long double));
+
+  for (R_len_t g = 0; g < n_out; ++g) {
+    p_sum[g] = 0;
+  }
+
+  for (R_len_t i = 0; i < n; ++i) {
+    double elt = p_x[i];
+
+    if (na_rm && isnan(elt)) {
+      continue;
+    }
+
+    p_sum[p_group_id[i] - 1] += elt;
+  }
+
+  SEXP out = PROTECT(Rf_allocVector(REALSXP, n_out));
+  double* p_out = REAL(out);
+
+  for (R_len_t g = 0; g < n_out; ++g) {
+    p_out[g] = (double) p_sum[g];
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// [[ register() ]]
+SEXP vctrs_group_sum(SEXP x, SEXP group_id, SEXP n_groups, SEXP na_rm) {
+  check_summary_numeric(x);
+
+  R_len_t n = Rf_length(x);
+  R_len_t n_out = check_group_id(group_id, n, n_groups);
+  const int* p_group_id = INTEGER_RO(group_id);
+  bool c_na_rm = check_na_rm(na_rm);
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: return int_group_sum(LOGICAL_RO(x), p_group_id, n, n_out, c_na_rm);
+  case INTSXP: return int_group_sum(INTEGER_RO(x), p_group_id, n, n_out, c_na_rm);
+  case REALSXP: return dbl_group_sum(REAL_RO(x), p_group_id, n, n_out, c_na_rm);
+  default: Rf_error("Internal error: Unexpected type in `vctrs_group_sum()`.");
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+#define INT_IS_NA(X) ((X) == NA_INTEGER)
+
+static void int_group_mean_fill(const int* p_x, const int* p_group_id, R_len_t n, bool na_rm,
+                                long double* p_sum, R_len_t* p_count, bool* p_na) {
+  for (R_len_t i = 0; i < n; ++i) {
+    int elt = p_x[i];
+    R_len_t g = p_group_id[i] - 1;
+
+    if (elt == NA_INTEGER) {
+      p_na[g] = p_na[g] || !na_rm;
+      continue;
+    }
+
+    p_sum[g] += elt;
+    ++p_count[g];
+  }
+}
+
+static void dbl_group_mean_fill(const double* p_x, const int* p_group_id, R_len_t n, bool na_rm,
+                                long double* p_sum, R_len_t* p_count) {
+  for (R_len_t i = 0; i < n; ++i) {
+    double elt = p_x[i];
+
+    // Missing values propagate through the sum if they are kept
+    if (na_rm && isnan(elt)) {
+      continue;
+    }
+
+    R_len_t g = p_group_id[i] - 1;
+    p_sum[g] += elt;
+    ++p_count[g];
+  }
+}
+
+// [[ register() ]]
+SEXP vctrs_group_mean(SEXP x, SEXP group_id, SEXP n_groups, SEXP na_rm) {
+  check_summary_numeric(x);
+
+  R_len_t n = Rf_length(x);
+  R_len_t n_out = check_group_id(group_id, n, n_groups);
+  const int* p_group_id = INTEGER_RO(group_id);
+  bool c_na_rm = check_na_rm(na_rm);
+
+  long double* p_sum = (long double*) R_alloc(n_out, sizeof(long double));
+  R_len_t* p_count = (R_len_t*) R_alloc(n_out, sizeof(R_len_t));
+  bool* p_na = (bool*) R_alloc(n_out, sizeof(bool));
+
+  for (R_len_t g = 0; g < n_out; ++g) {
+    p_sum[g] = 0;
+    p_count[g] = 0;
+    p_na[g] = false;
+  }
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: int_group_mean_fill(LOGICAL_RO(x), p_group_id, n, c_na_rm, p_sum, p_count, p_na); break;
+  case INTSXP: int_group_mean_fill(INTEGER_RO(x), p_group_id, n, c_na_rm, p_sum, p_count, p_na); break;
+  case REALSXP: dbl_group_mean_fill(REAL_RO(x), p_group_id, n, c_na_rm, p_sum, p_count); break;
+  default: Rf_error("Internal error: Unexpected type in `vctrs_group_mean()`.");
+  }
+
+  SEXP out = PROTECT(Rf_allocVector(REALSXP, n_out));
+  double* p_out = REAL(out);
+
+  for (R_len_t g = 0; g < n_out; ++g) {
+    if (p_na[g]) {
+      p_out[g] = NA_REAL;
+    } else {
+      // Empty groups have a `NaN` mean, like `mean(double())`
+      p_out[g] = (double) (p_sum[g] / p_count[g]);
+    }
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+#define GROUP_EXTREMUM(RTYPE, CTYPE, CONST_DEREF, DEREF, IS_NA, IS_NA_VALUE, NA_VALUE) \
+  const CTYPE* p_x = CONST_DEREF(x);                                    \
+                                                                        \
+  SEXP out = PROTECT(Rf_allocVector(RTYPE, n_out));                     \
+  CTYPE* p_out = DEREF(out);                                            \
+                                                                        \
+  /* Groups are missing until they have a value */                      \
+  for (R_len_t g = 0; g < n_out; ++g) {                                 \
+    p_out[g] = NA_VALUE;                                                \
+    p_seen[g] = false;                                                  \
+  }                                                                     \
+                                                                        \
+  for (R_len_t i = 0; i < n; ++i) {                                     \
+    CTYPE elt = p_x[i];                                                 \
+    R_len_t g = p_group_id[i] - 1;                                      \
+                                                                        \
+    if (IS_NA(elt)) {                                                   \
+      /* Like base, `NA` takes precedence over `NaN` */                 \
+      if (!na_rm && (!p_done[g] || IS_NA_VALUE(elt))) {                 \
+        p_out[g] = elt;                                                 \
+        p_done[g] = true;                                               \
+      }                                                                 \
+      continue;                                                         \
+    }                                                                   \
+                                                                        \
+    if (p_done[g]) {                                                    \
+      continue;                                                         \
+    }                                                                   \
+                                                                        \
+    if (!p_seen[g] || (is_max ? elt > p_out[g] : elt < p_out[g])) {     \
+      p_out[g] = elt;                                                   \
+      p_seen[g] = true;                                                 \
+    }                                                                   \
+  }                                                                     \
+                                                                        \
+  UNPROTECT(1);                                                         \
+  return out
+
+static SEXP int_group_extremum(SEXP x, const int* p_group_id, R_len_t n, R_len_t n_out,
+                               bool na_rm, bool is_max, bool* p_seen, bool* p_done) {
+  if (TYPEOF(x) == LGLSXP) {
+    GROUP_EXTREMUM(INTSXP, int, LOGICAL_RO, INTEGER, INT_IS_NA, INT_IS_NA, NA_INTEGER);
+  } else {
+    GROUP_EXTREMUM(INTSXP, int, INTEGER_RO, INTEGER, INT_IS_NA, INT_IS_NA, NA_INTEGER);
+  }
+}
+static SEXP dbl_group_extremum(SEXP x, const int* p_group_id, R_len_t n, R_len_t n_out,
+                               bool na_rm, bool is_max, bool* p_seen, bool* p_done) {
+  GROUP_EXTREMUM(REALSXP, double, REAL_RO, REAL, isnan, R_IsNA, NA_REAL);
+}
+
+#undef GROUP_EXTREMUM
+#undef INT_IS_NA
+
+static SEXP vec_group_extremum(SEXP x, SEXP group_id, SEXP n_groups, SEXP na_rm, bool is_max) {
+  check_summary_numeric(x);
+
+  R_len_t n = Rf_length(x);
+  R_len_t n_out = check_group_id(group_id, n, n_groups);
+  const int* p_group_id = INTEGER_RO(group_id);
+  bool c_na_rm = check_na_rm(na_rm);
+
+  // Whether a group has a value yet, and whether it is known to be
+  // missing
+  bool* p_seen = (bool*) R_alloc(n_out, sizeof(bool));
+  bool* p_done = (bool*) R_alloc(n_out, sizeof(bool));
+  memset(p_done, 0, n_out * sizeof(bool));
+
+  switch (TYPEOF(x)) {
+  case LGLSXP:
+  case INTSXP: return int_group_extremum(x, p_group_id, n, n_out, c_na_rm, is_max, p_seen, p_done);
+  case REALSXP: return dbl_group_extremum(x, p_group_id, n, n_out, c_na_rm, is_max, p_seen, p_done);
+  default: Rf_error("Internal error: Unexpected type in `vec_group_extremum()`.");
+  }
+}
+
+// [[ register() ]]
+SEXP vctrs_group_min(SEXP x, SEXP group_id, SEXP n_groups, SEXP na_rm) {
+  return vec_group_extremum(x, group_id, n_groups, na_rm, false);
+}
+// [[ register() ]]
+SEXP vctrs_group_max(SEXP x, SEXP group_id, SEXP n_groups, SEXP na_rm) {
+  return vec_group_extremum(x, group_id, n_groups, na_rm, true);
+}
+
+// -----------------------------------------------------------------------------
+
+static SEXP vec_group_nth(SEXP x, SEXP group_id, SEXP n_groups, bool last) {
+  R_len_t n = vec_size(x);
+  R_len_t n_out = check_group_id(group_id, n, n_groups);
+  const int* p_group_id = INTEGER_RO(group_id);
+
+  // Empty groups are sliced with a missing location
+  SEXP loc = PROTECT(Rf_allocVector(INTSXP, n_out));
+  int* p_loc = INTEGER(loc);
+
+  for (R_len_t g = 0; g < n_out; ++g) {
+    p_loc[g] = NA_INTEGER;
+  }
+
+  for (R_len_t i = 0; i < n; ++i) {
+    R_len_t g = p_group_id[i] - 1;
+
+    if (last || p_loc[g] == NA_INTEGER) {
+      p_loc[g] = i + 1;
+    }
+  }
+
+  SEXP out = vec_slice(x, loc);
+
+  UNPROTECT(1);
+  return out;
+}
+
+// [[ register() ]]
+SEXP vctrs_group_first(SEXP x, SEXP group_id, SEXP n_groups) {
+  return vec_group_nth(x, group_id, n_groups, false);
+}
+// [[ register() ]]
+SEXP vctrs_group_last(SEXP x, SEXP group_id, SEXP n_groups) {
+  return vec_group_nth(x, group_id, n_groups, true);
+}
+
+// -----------------------------------------------------------------------------
+
+// [[ register() ]]
+SEXP vctrs_group_n_distinct(SEXP x, SEXP group_id, SEXP n_groups) {
+  int nprot = 0;
+
+  R_len_t n = vec_size(x);
+  R_len_t n_out = check_group_id(group_id, n, n_groups);
+  const int* p_group_id = INTEGER_RO(group_id);
+
+  // Identify the values of `x`
+  SEXP values = PROTECT_N(Rf_allocVector(INTSXP, n), &nprot);
+  int* p_values = INTEGER(values);
+  R_len_t n_values = group_id_fill(x, n, p_values);
+
+  // Visit elements group by group
+  int* p_order = (int*) R_alloc(n, sizeof(int));
+  int* p_offset = (int*) R_alloc(n_out + 1, sizeof(int));
+  group_order_fill(p_group_id, n, n_out, p_order, p_offset);
+
+  // The last group in which each value was seen
+  int* p_last_group = (int*) R_alloc(n_values, sizeof(int));
+
+  for (R_len_t v = 0; v < n_values; ++v) {
+    p_last_group[v] = 0;
+  }
+
+  SEXP out = PROTECT_N(Rf_allocVector(INTSXP, n_out), &nprot);
+  int* p_out = INTEGER(out);
+  memset(p_out, 0, n_out * sizeof(int));
+
+  for (R_len_t k = 0; k < n; ++k) {
+    R_len_t i = p_order[k];
+    int group = p_group_id[i];
+    int value = p_values[i];
+
+    if (p_last_group[value] != group) {
+      p_last_group[value] = group;
+      ++p_out[group - 1];
+    }
+  }
+
+  UNPROTECT(nprot);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+/**
+ * Order elements by group
+ *
+ * Fills `p_order` with the 0-based locations of the elements of each
+ * group, one group after the other, with a stable counting sort.
+ * Locations are increasing within a group. `p_offset` has size
+ * `n_groups + 1` and is filled with the start of each group in
+ * `p_order`.
+ *
+ * [[ include("vctrs.h") ]]
+ */
+void group_order_fill(const int* p_group_id,
+                      R_len_t n,
+                      R_len_t n_groups,
+                      int* p_order,
+                      int* p_offset) {
+  // Group sizes are counted shifted by one so they can be cumulated
+  // into offsets in place
+  memset(p_offset, 0, (n_groups + 1) * sizeof(int));
+
+  for (R_len_t i = 0; i < n; ++i) {
+    ++p_offset[p_group_id[i]];
+  }
+  for (R_len_t g = 0; g < n_groups; ++g) {
+    p_offset[g + 1] += p_offset[g];
+  }
+
+  int* p_pos = (int*) R_alloc(n_groups, sizeof(int));
+  memcpy(p_pos, p_offset, n_groups * sizeof(int));
+
+  for (R_len_t i = 0; i < n; ++i) {
+    p_order[p_pos[p_group_id[i] - 1]++] = i;
+  }
+}
+
+/**
+ * Check 1-based group identifiers
+ *
+ * Returns the number of groups.
+ *
+ * [[ include("vctrs.h") ]]
+ */
+R_len_t check_group_id(SEXP group_id, R_len_t size, SEXP n_groups) {
+  if (TYPEOF(n_groups) == REALSXP && Rf_length(n_groups) == 1) {
+    double n_groups_dbl = REAL(n_groups)[0];
+
+    if (n_groups_dbl >= 0 && n_groups_dbl <= INT_MAX && n_groups_dbl == (int) n_groups_dbl) {
+      n_groups = r_int((int) n_groups_dbl);
+    }
+  }
+  PROTECT(n_groups);
+
+  if (!r_is_number(n_groups) || INTEGER(n_groups)[0] < 0) {
+    Rf_errorcall(R_NilValue, "`n_groups` must be a single non-negative integer.");
+  }
+
+  R_len_t n_out = INTEGER(n_groups)[0];
+  UNPROTECT(1);
+
+  if (TYPEOF(group_id) != INTSXP) {
+    Rf_errorcall(R_NilValue, "`group_id` must be an integer vector.");
+  }
+  if (Rf_length(group_id) != size) {
+    Rf_errorcall(R_NilValue,
+                 "`group_id` must have size %d, not size %d.",
+                 size,
+                 Rf_length(group_id));
+  }
+
+  const int* p_group_id = INTEGER_RO(group_id);
+
+  for (R_len_t i = 0; i < size; ++i) {
+    int elt = p_group_id[i];
+
+    if (elt == NA_INTEGER || elt < 1 || elt > n_out) {
+      Rf_errorcall(R_NilValue,
+                   "`group_id` must contain group identifiers between 1 and `n_groups`. "
+                   "Element %d is invalid.",
+                   i + 1);
+    }
+  }
+
+  return n_out;
+}
+
+// [[ include("vctrs.h") ]]
+void check_summary_numeric(SEXP x) {
+  switch (TYPEOF(x)) {
+  case LGLSXP:
+  case INTSXP:
+  case REALSXP:
+    if (!OBJECT(x) && !has_dim(x)) {
+      return;
+    }
+  default:
+    Rf_errorcall(R_NilValue, "`x` must be a bare logical, integer, or double vector.");
+  }
+}
+
+static bool check_na_rm(SEXP na_rm) {
+  if (!r_is_bool(na_rm)) {
+    Rf_errorcall(R_NilValue, "`na_rm` must be `TRUE` or `FALSE`.");
+  }
+  return LOGICAL(na_rm)[0];
+}
@@ -0,0 +1,173 @@
+#include "vctrs.h"
+#include "utils.h"
+
+// Grouped window functions
+//
+// These compute one value per element of `x` in a single pass, given
+// the 1-based group identifiers returned by `vec_group_id()`. Each
+// group keeps its own state, so elements are visited in their
+// original order and the results are parallel to `x`.
+
+// [[ register() ]]
+SEXP vctrs_group_seq(SEXP group_id, SEXP n_groups) {
+  R_len_t n = Rf_length(group_id);
+  R_len_t n_out = check_group_id(group_id, n, n_groups);
+  const int* p_group_id = INTEGER_RO(group_id);
+
+  // Number of elements seen so far in each group
+  int* p_count = (int*) R_alloc(n_out, sizeof(int));
+  memset(p_count, 0, n_out * sizeof(int));
+
+  SEXP out = PROTECT(Rf_allocVector(INTSXP, n));
+  int* p_out = INTEGER(out);
+
+  for (R_len_t i = 0; i < n; ++i) {
+    p_out[i] = ++p_count[p_group_id[i] - 1];
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+
+static SEXP int_group_cumsum(const int* p_x, const int* p_group_id, R_len_t n, R_len_t n_out) {
+  int64_t* p_sum = (int64_t*) R_alloc(n_out, sizeof(int64_t));
+  memset(p_sum, 0, n_out * sizeof(int64_t));
+
+  // Once a group has a missing value, its cumulative sum stays missing
+  bool* p_na = (bool*) R_alloc(n_out, sizeof(bool));
+  memset(p_na, 0, n_out * sizeof(bool));
+
+  SEXP out = PROTECT(Rf_allocVector(INTSXP, n));
+  int* p_out = INTEGER(out);
+
+  bool overflow = false;
+
+  for (R_len_t i = 0; i < n; ++i) {
+    int elt = p_x[i];
+    R_len_t g = p_group_id[i] - 1;
+
+    if (p_na[g] || elt == NA_INTEGER) {
+      p_na[g] = true;
+      p_out[i] = NA_INTEGER;
+      continue;
+    }
+
+    int64_t sum = p_sum[g] + elt;
+
+    // Like `cumsum()`, the sum is missing from the first overflow onwards
+    if (sum > INT_MAX || sum <= INT_MIN) {
+      p_na[g] = true;
+      p_out[i] = NA_INTEGER;
+      overflow = true;
+      continue;
+    }
+
+    p_sum[g] = sum;
+    p_out[i] = (int) sum;
+  }
+
+  if (overflow) {
+    Rf_warningcall(R_NilValue,
+                   "Integer overflow in `vec_group_cumsum()`, returning `NA`. "
+                   "Convert `x` to double first.");
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+static SEXP dbl_group_cumsum(const double* p_x, const int* p_group_id, R_len_t n, R_len_t n_out) {
+  long double* p_sum = (long double*) R_alloc(n_out, sizeof(long double));
+
+  for (R_len_t g = 0; g < n_out; ++g) {
+    p_sum[g] = 0;
+  }
+
+  SEXP out = PROTECT(Rf_allocVector(REALSXP, n));
+  double* p_out = REAL(out);
+
+  for (R_len_t i = 0; i < n; ++i) {
+    R_len_t g = p_group_id[i] - 1;
+    p_sum[g] += p_x[i];
+    p_out[i] = (double) p_sum[g];
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// [[ register() ]]
+SEXP vctrs_group_cumsum(SEXP x, SEXP group_id, SEXP n_groups) {
+  check_summary_numeric(x);
+
+  R_len_t n = Rf_length(x);
+  R_len_t n_out = check_group_id(group_id, n, n_groups);
+  const int* p_group_id = INTEGER_RO(group_id);
+
+  switch (TYPEOF(x)) {
+  case LGLSXP: return int_group_cumsum(LOGICAL_RO(x), p_group_id, n, n_out);
+  case INTSXP: return int_group_cumsum(INTEGER_RO(x), p_group_id, n, n_out);
+  case REALSXP: return dbl_group_cumsum(REAL_RO(x), p_group_id, n, n_out);
+  default: Rf_error("Internal error: Unexpected type in `vctrs_group_cumsum()`.");
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+ * Shift `x` by `n` elements within groups. The elements are ordered
+ * by group so that the source of each element is `n` positions away
+ * in the same group. Elements without a source are missing. `x` is
+ * then sliced once, so any vector type can be shifted.
+ */
+static SEXP vec_group_shift(SEXP x, SEXP group_id, SEXP n, SEXP n_groups, bool lag) {
+  R_len_t size = vec_size(x);
+  R_len_t n_out = check_group_id(group_id, size, n_groups);
+  const int* p_group_id = INTEGER_RO(group_id);
+
+  if (!r_is_number(n) || INTEGER(n)[0] < 0) {
+    Rf_errorcall(R_NilValue, "`n` must be a single non-negative integer.");
+  }
+  R_len_t shift = INTEGER(n)[0];
+
+  int* p_order = (int*) R_alloc(size, sizeof(int));
+  int* p_offset = (int*) R_alloc(n_out + 1, sizeof(int));
+  group_order_fill(p_group_id, size, n_out, p_order, p_offset);
+
+  SEXP loc = PROTECT(Rf_allocVector(INTSXP, size));
+  int* p_loc = INTEGER(loc);
+
+  for (R_len_t g = 0; g < n_out; ++g) {
+    R_len_t start = p_offset[g];
+    R_len_t end = p_offset[g + 1];
+
+    for (R_len_t k = start; k < end; ++k) {
+      // Compare against the distance to the group boundary to avoid
+      // overflowing with large `n`
+      bool has_source = lag ? (k - start >= shift) : (end - 1 - k >= shift);
+
+      if (has_source) {
+        R_len_t source = lag ? k - shift : k + shift;
+        p_loc[p_order[k]] = p_order[source] + 1;
+      } else {
+        p_loc[p_order[k]] = NA_INTEGER;
+      }
+    }
+  }
+
+  SEXP out = vec_slice(x, loc);
+
+  UNPROTECT(1);
+  return out;
+}
+
+// [[ register() ]]
+SEXP vctrs_group_lag(SEXP x, SEXP group_id, SEXP n, SEXP n_groups) {
+  return vec_group_shift(x, group_id, n, n_groups, true);
+}
+// [[ register() ]]
+SEXP vctrs_group_lead(SEXP x, SEXP group_id, SEXP n, SEXP n_groups) {
+  return vec_group_shift(x, group_id, n, n_groups, false);
+}
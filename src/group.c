@@ -1,4 +1,5 @@
 #include "vctrs.h"
+#include "altrep-rle.h"
 #include "dictionary.h"
 #include "type-data-frame.h"
 #include "utils.h"
@@ -9,33 +10,17 @@ SEXP vctrs_group_id(SEXP x) {
 
   R_len_t n = vec_size(x);
 
-  x = PROTECT_N(vec_proxy_equal(x), &nprot);
-  x = PROTECT_N(obj_maybe_translate_encoding(x, n), &nprot);
-
-  struct dictionary d;
-  dict_init(&d, x);
-  PROTECT_DICT(&d, &nprot);
-
   SEXP out = PROTECT_N(Rf_allocVector(INTSXP, n), &nprot);
   int* p_out = INTEGER(out);
 
-  R_len_t g = 1;
+  R_len_t n_groups = group_id_fill(x, n, p_out);
 
-  for (int i = 0; i < n; ++i) {
-    int32_t hash = dict_hash_scalar(&d, i);
-    R_len_t key = d.key[hash];
-
-    if (key == DICT_EMPTY) {
-      dict_put(&d, hash, i);
-      p_out[i] = g;
-      ++g;
-    } else {
-      p_out[i] = p_out[key];
-    }
+  for (R_len_t i = 0; i < n; ++i) {
+    ++p_out[i];
   }
 
-  SEXP n_groups = PROTECT_N(Rf_ScalarInteger(d.used), &nprot);
-  Rf_setAttrib(out, syms_n, n_groups);
+  SEXP n_groups_sexp = PROTECT_N(Rf_ScalarInteger(n_groups), &nprot);
+  Rf_setAttrib(out, syms_n, n_groups_sexp);
 
   UNPROTECT(nprot);
   return out;
@@ -44,11 +29,19 @@ SEXP vctrs_group_id(SEXP x) {
 // -----------------------------------------------------------------------------
 
 static SEXP new_group_rle(SEXP g, SEXP l, R_len_t n);
+static SEXP group_rle_runs(SEXP runs);
 
 // [[ register() ]]
 SEXP vctrs_group_rle(SEXP x) {
   int nprot = 0;
 
+  SEXP runs = PROTECT_N(altrep_rle_runs(x), &nprot);
+  if (runs != R_NilValue) {
+    SEXP out = group_rle_runs(runs);
+    UNPROTECT(nprot);
+    return out;
+  }
+
   R_len_t n = vec_size(x);
 
   x = PROTECT_N(vec_proxy_equal(x), &nprot);
@@ -115,6 +108,48 @@ SEXP vctrs_group_rle(SEXP x) {
   return out;
 }
 
+// With run length encoded inputs, only the run values are grouped.
+// Adjacent runs of the same group are then merged.
+static SEXP group_rle_runs(SEXP runs) {
+  int nprot = 0;
+
+  SEXP values = VECTOR_ELT(runs, 0);
+  const int* p_lengths = INTEGER_RO(VECTOR_ELT(runs, 1));
+  R_len_t n_runs = Rf_length(values);
+
+  int* p_run_groups = (int*) R_alloc(n_runs, sizeof(int));
+  R_len_t n_groups = group_id_fill(values, n_runs, p_run_groups);
+
+  SEXP g = PROTECT_N(Rf_allocVector(INTSXP, n_runs), &nprot);
+  int* p_g = INTEGER(g);
+
+  SEXP l = PROTECT_N(Rf_allocVector(INTSXP, n_runs), &nprot);
+  int* p_l = INTEGER(l);
+
+  R_len_t loc = -1;
+
+  for (R_len_t i = 0; i < n_runs; ++i) {
+    int group = p_run_groups[i] + 1;
+
+    if (loc >= 0 && p_g[loc] == group) {
+      p_l[loc] += p_lengths[i];
+      continue;
+    }
+
+    ++loc;
+    p_g[loc] = group;
+    p_l[loc] = p_lengths[i];
+  }
+
+  g = PROTECT_N(Rf_lengthgets(g, loc + 1), &nprot);
+  l = PROTECT_N(Rf_lengthgets(l, loc + 1), &nprot);
+
+  SEXP out = new_group_rle(g, l, n_groups);
+
+  UNPROTECT(nprot);
+  return out;
+}
+
 static SEXP new_group_rle(SEXP g, SEXP l, R_len_t n) {
   SEXP out = PROTECT(Rf_allocVector(VECSXP, 2));
 
@@ -137,60 +172,43 @@ static SEXP new_group_rle(SEXP g, SEXP l, R_len_t n) {
 
 // -----------------------------------------------------------------------------
 
-// [[ include("vctrs.h"); register() ]]
+static void group_key_loc_fill(const int* p_groups,
+                               R_len_t n,
+                               R_len_t n_groups,
+                               int* p_key_loc,
+                               int* p_counts);
+static SEXP new_group_loc(SEXP key, SEXP loc, R_len_t n_groups);
+static SEXP new_group_loc_compact(SEXP key, SEXP loc, SEXP offset);
+
+// [[ register() ]]
+SEXP vctrs_group_loc(SEXP x, SEXP format) {
+  if (STRING_ELT(format, 0) == strings_compact) {
+    return vec_group_loc_compact(x);
+  } else {
+    return vec_group_loc(x);
+  }
+}
+
+// [[ include("vctrs.h") ]]
 SEXP vec_group_loc(SEXP x) {
   int nprot = 0;
 
   R_len_t n = vec_size(x);
 
-  SEXP proxy = PROTECT_N(vec_proxy_equal(x), &nprot);
-  proxy = PROTECT_N(obj_maybe_translate_encoding(proxy, n), &nprot);
-
-  struct dictionary d;
-  dict_init(&d, proxy);
-  PROTECT_DICT(&d, &nprot);
-
   SEXP groups = PROTECT_N(Rf_allocVector(INTSXP, n), &nprot);
   int* p_groups = INTEGER(groups);
 
-  R_len_t g = 0;
-
-  // Identify groups, this is essentially `vec_group_id()`
-  for (int i = 0; i < n; ++i) {
-    int32_t hash = dict_hash_scalar(&d, i);
-    R_len_t key = d.key[hash];
-
-    if (key == DICT_EMPTY) {
-      dict_put(&d, hash, i);
-      p_groups[i] = g;
-      ++g;
-    } else {
-      p_groups[i] = p_groups[key];
-    }
-  }
-
-  int n_groups = d.used;
+  R_len_t n_groups = group_id_fill(x, n, p_groups);
 
   // Location of first occurence of each group in `x`
   SEXP key_loc = PROTECT_N(Rf_allocVector(INTSXP, n_groups), &nprot);
   int* p_key_loc = INTEGER(key_loc);
-  int key_loc_current = 0;
 
   // Count of the number of elements in each group
   SEXP counts = PROTECT_N(Rf_allocVector(INTSXP, n_groups), &nprot);
   int* p_counts = INTEGER(counts);
-  memset(p_counts, 0, n_groups * sizeof(int));
-
-  for (int i = 0; i < n; ++i) {
-    int group = p_groups[i];
 
-    if (group == key_loc_current) {
-      p_key_loc[key_loc_current] = i + 1;
-      key_loc_current++;
-    }
-
-    p_counts[group]++;
-  }
+  group_key_loc_fill(p_groups, n, n_groups, p_key_loc, p_counts);
 
   SEXP out_loc = PROTECT_N(Rf_allocVector(VECSXP, n_groups), &nprot);
 
@@ -213,14 +231,191 @@ SEXP vec_group_loc(SEXP x) {
     p_locations[group]++;
   }
 
-  SEXP out_key = PROTECT_N(vec_slice(x, key_loc), &nprot);
+  SEXP out_key = PROTECT_N(vec_slice_trusted(x, key_loc), &nprot);
+
+  SEXP out = new_group_loc(out_key, out_loc, n_groups);
+
+  UNPROTECT(nprot);
+  return out;
+}
+
+/**
+ * Group locations in compressed sparse row layout
+ *
+ * Instead of allocating one integer vector per group, the locations
+ * of all groups are stored contiguously in a single permutation `loc`
+ * of `vec_seq_along(x)`. The locations of group `i` are
+ * `loc[(offset[i] + 1):offset[i + 1]]`, where `offset` has size
+ * `n_groups + 1`. Within a group, locations are increasing.
+ *
+ * The result can be passed as `indices` to `vec_chop()`.
+ *
+ * [[ include("vctrs.h") ]]
+ */
+SEXP vec_group_loc_compact(SEXP x) {
+  int nprot = 0;
+
+  R_len_t n = vec_size(x);
+
+  SEXP groups = PROTECT_N(Rf_allocVector(INTSXP, n), &nprot);
+  int* p_groups = INTEGER(groups);
+
+  R_len_t n_groups = group_id_fill(x, n, p_groups);
+
+  SEXP key_loc = PROTECT_N(Rf_allocVector(INTSXP, n_groups), &nprot);
+  int* p_key_loc = INTEGER(key_loc);
+
+  // Group counts are stored shifted by one so they can be cumulated
+  // into offsets in place
+  SEXP offset = PROTECT_N(Rf_allocVector(INTSXP, n_groups + 1), &nprot);
+  int* p_offset = INTEGER(offset);
+  p_offset[0] = 0;
+
+  group_key_loc_fill(p_groups, n, n_groups, p_key_loc, p_offset + 1);
+
+  for (R_len_t i = 0; i < n_groups; ++i) {
+    p_offset[i + 1] += p_offset[i];
+  }
+
+  // Next position to fill in `loc` for each group
+  SEXP positions = PROTECT_N(Rf_allocVector(INTSXP, n_groups), &nprot);
+  int* p_positions = INTEGER(positions);
+  memcpy(p_positions, p_offset, n_groups * sizeof(int));
+
+  SEXP loc = PROTECT_N(Rf_allocVector(INTSXP, n), &nprot);
+  int* p_loc = INTEGER(loc);
+
+  for (R_len_t i = 0; i < n; ++i) {
+    p_loc[p_positions[p_groups[i]]++] = i + 1;
+  }
+
+  SEXP key = PROTECT_N(vec_slice_trusted(x, key_loc), &nprot);
+
+  SEXP out = new_group_loc_compact(key, loc, offset);
+
+  UNPROTECT(nprot);
+  return out;
+}
+
+static SEXP new_group_loc_compact(SEXP key, SEXP loc, SEXP offset) {
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, 3));
+
+  SET_VECTOR_ELT(out, 0, key);
+  SET_VECTOR_ELT(out, 1, loc);
+  SET_VECTOR_ELT(out, 2, offset);
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP, 3));
+  SET_STRING_ELT(names, 0, strings_key);
+  SET_STRING_ELT(names, 1, strings_loc);
+  SET_STRING_ELT(names, 2, strings_offset);
+  Rf_setAttrib(out, R_NamesSymbol, names);
+
+  Rf_setAttrib(out, R_ClassSymbol, classes_vctrs_group_loc_compact);
+
+  UNPROTECT(2);
+  return out;
+}
+
+// [[ register() ]]
+SEXP vctrs_group_loc_sorted(SEXP x, SEXP proxy, SEXP format) {
+  return vec_group_loc_sorted(x, proxy, STRING_ELT(format, 0) == strings_compact);
+}
+
+/**
+ * Group locations sorted by key
+ *
+ * Sorts `proxy` with `proxy_order_fill()` and forms groups from runs
+ * of equal values, without a dictionary. Locations are computed in
+ * the compact layout of `vec_group_loc_compact()` and are then
+ * converted to a list if `compact` is false.
+ *
+ * @param proxy The comparison proxy of `x`.
+ *
+ * [[ include("vctrs.h") ]]
+ */
+SEXP vec_group_loc_sorted(SEXP x, SEXP proxy, bool compact) {
+  int nprot = 0;
+
+  R_len_t n = vec_size(x);
+
+  if (vec_size(proxy) != n) {
+    Rf_errorcall(R_NilValue, "Internal error: `proxy` must have the same size as `x`.");
+  }
+
+  // Strings are ordered by their bytes in UTF-8
+  proxy = PROTECT_N(obj_maybe_translate_encoding(proxy, n), &nprot);
+  proxy = PROTECT_N(obj_translate_utf8(proxy, n), &nprot);
+
+  SEXP loc = PROTECT_N(Rf_allocVector(INTSXP, n), &nprot);
+  int* p_loc = INTEGER(loc);
+
+  proxy_order_fill(proxy, n, p_loc);
+
+  // A new group starts wherever consecutive sorted values differ
+  PROTECT_INDEX offset_pi;
+  SEXP offset = Rf_allocVector(INTSXP, n + 1);
+  PROTECT_WITH_INDEX(offset, &offset_pi);
+  ++nprot;
+  int* p_offset = INTEGER(offset);
+
+  R_len_t n_groups = 0;
+
+  for (R_len_t i = 0; i < n; ++i) {
+    if (i == 0 || !equal_scalar(proxy, p_loc[i - 1], proxy, p_loc[i], true)) {
+      p_offset[n_groups] = i;
+      ++n_groups;
+    }
+  }
+  p_offset[n_groups] = n;
+
+  offset = Rf_lengthgets(offset, n_groups + 1);
+  REPROTECT(offset, offset_pi);
+  p_offset = INTEGER(offset);
+
+  // The sort is stable, so the first location of each group is the
+  // location of its first occurrence
+  SEXP key_loc = PROTECT_N(Rf_allocVector(INTSXP, n_groups), &nprot);
+  int* p_key_loc = INTEGER(key_loc);
+
+  for (R_len_t i = 0; i < n; ++i) {
+    ++p_loc[i];
+  }
+  for (R_len_t i = 0; i < n_groups; ++i) {
+    p_key_loc[i] = p_loc[p_offset[i]];
+  }
+
+  SEXP key = PROTECT_N(vec_slice_trusted(x, key_loc), &nprot);
+
+  if (compact) {
+    SEXP out = new_group_loc_compact(key, loc, offset);
+    UNPROTECT(nprot);
+    return out;
+  }
+
+  SEXP out_loc = PROTECT_N(Rf_allocVector(VECSXP, n_groups), &nprot);
+
+  for (R_len_t i = 0; i < n_groups; ++i) {
+    R_len_t start = p_offset[i];
+    R_len_t size = p_offset[i + 1] - start;
+
+    SEXP elt = Rf_allocVector(INTSXP, size);
+    SET_VECTOR_ELT(out_loc, i, elt);
+
+    memcpy(INTEGER(elt), p_loc + start, size * sizeof(int));
+  }
 
-  // Construct output data frame
-  SEXP out = PROTECT_N(Rf_allocVector(VECSXP, 2), &nprot);
-  SET_VECTOR_ELT(out, 0, out_key);
-  SET_VECTOR_ELT(out, 1, out_loc);
+  SEXP out = new_group_loc(key, out_loc, n_groups);
 
-  SEXP names = PROTECT_N(Rf_allocVector(STRSXP, 2), &nprot);
+  UNPROTECT(nprot);
+  return out;
+}
+
+static SEXP new_group_loc(SEXP key, SEXP loc, R_len_t n_groups) {
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(out, 0, key);
+  SET_VECTOR_ELT(out, 1, loc);
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP, 2));
   SET_STRING_ELT(names, 0, strings_key);
   SET_STRING_ELT(names, 1, strings_loc);
 
@@ -228,6 +423,127 @@ SEXP vec_group_loc(SEXP x) {
 
   out = new_data_frame(out, n_groups);
 
-  UNPROTECT(nprot);
+  UNPROTECT(2);
   return out;
 }
+
+static R_len_t group_id_fill_rle(SEXP runs, int* p_groups);
+static R_len_t group_id_fill_runs(SEXP proxy, R_len_t n, int* p_groups);
+static R_len_t group_id_fill_dict(SEXP proxy, R_len_t n, int* p_groups);
+
+// Identify groups, this is essentially `vec_group_id()` with 0-based
+// identifiers. Returns the number of groups.
+// [[ include("vctrs.h") ]]
+R_len_t group_id_fill(SEXP x, R_len_t n, int* p_groups) {
+  int nprot = 0;
+
+  SEXP runs = PROTECT_N(altrep_rle_runs(x), &nprot);
+  if (runs != R_NilValue) {
+    R_len_t n_groups = group_id_fill_rle(runs, p_groups);
+    UNPROTECT(nprot);
+    return n_groups;
+  }
+
+  SEXP proxy = PROTECT_N(vec_proxy_equal(x), &nprot);
+  proxy = PROTECT_N(obj_maybe_translate_encoding(proxy, n), &nprot);
+
+  R_len_t n_groups;
+
+  if (proxy_is_monotonic(proxy, n)) {
+    n_groups = group_id_fill_runs(proxy, n, p_groups);
+  } else {
+    n_groups = group_id_fill_dict(proxy, n, p_groups);
+  }
+
+  UNPROTECT(nprot);
+  return n_groups;
+}
+
+// Run length encoded vectors are grouped by their run values, without
+// being materialized. The identifiers of the runs are then expanded.
+static R_len_t group_id_fill_rle(SEXP runs, int* p_groups) {
+  SEXP values = VECTOR_ELT(runs, 0);
+  const int* p_lengths = INTEGER_RO(VECTOR_ELT(runs, 1));
+  R_len_t n_runs = Rf_length(values);
+
+  int* p_run_groups = (int*) R_alloc(n_runs, sizeof(int));
+  R_len_t n_groups = group_id_fill(values, n_runs, p_run_groups);
+
+  for (R_len_t i = 0; i < n_runs; ++i) {
+    int group = p_run_groups[i];
+
+    for (R_len_t j = 0; j < p_lengths[i]; ++j) {
+      *p_groups++ = group;
+    }
+  }
+
+  return n_groups;
+}
+
+// Each run of a monotonic proxy is a new group
+static R_len_t group_id_fill_runs(SEXP proxy, R_len_t n, int* p_groups) {
+  if (n == 0) {
+    return 0;
+  }
+
+  R_len_t g = 0;
+  p_groups[0] = g;
+
+  for (R_len_t i = 1; i < n; ++i) {
+    if (!equal_scalar(proxy, i - 1, proxy, i, true)) {
+      ++g;
+    }
+    p_groups[i] = g;
+  }
+
+  return g + 1;
+}
+
+static R_len_t group_id_fill_dict(SEXP proxy, R_len_t n, int* p_groups) {
+  int nprot = 0;
+
+  struct dictionary d;
+  dict_init(&d, proxy);
+  PROTECT_DICT(&d, &nprot);
+
+  R_len_t g = 0;
+
+  for (int i = 0; i < n; ++i) {
+    int32_t hash = dict_hash_scalar(&d, i);
+    R_len_t key = d.key[hash];
+
+    if (key == DICT_EMPTY) {
+      dict_put(&d, hash, i);
+      p_groups[i] = g;
+      ++g;
+    } else {
+      p_groups[i] = p_groups[key];
+    }
+  }
+
+  UNPROTECT(nprot);
+  return d.used;
+}
+
+// Fills the 1-based location of the first occurrence of each group,
+// and the number of elements in each group
+static void group_key_loc_fill(const int* p_groups,
+                               R_len_t n,
+                               R_len_t n_groups,
+                               int* p_key_loc,
+                               int* p_counts) {
+  int key_loc_current = 0;
+
+  memset(p_counts, 0, n_groups * sizeof(int));
+
+  for (int i = 0; i < n; ++i) {
+    int group = p_groups[i];
+
+    if (group == key_loc_current) {
+      p_key_loc[key_loc_current] = i + 1;
+      key_loc_current++;
+    }
+
+    p_counts[group]++;
+  }
+}
@@ -50,6 +50,48 @@ static uint32_t hash_char(SEXP x) {
   return hash_int64((intptr_t) x);
 }
 
+// 64-bit hash from murmurhash, for hashing whole vectors of types whose
+// equality is bitwise
+// https://github.com/aappleby/smhasher/blob/master/src/MurmurHash2.cpp#L96
+static uint32_t hash_bytes(const void* p, size_t size) {
+  const uint64_t m = UINT64_C(0xc6a4a7935bd1e995);
+  const int r = 47;
+
+  const unsigned char* p_bytes = (const unsigned char*) p;
+  uint64_t hash = size * m;
+
+  size_t n_words = size / sizeof(uint64_t);
+
+  for (size_t i = 0; i < n_words; ++i, p_bytes += sizeof(uint64_t)) {
+    uint64_t k;
+    memcpy(&k, p_bytes, sizeof(uint64_t));
+
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+
+    hash ^= k;
+    hash *= m;
+  }
+
+  switch (size & 7) {
+  case 7: hash ^= (uint64_t) p_bytes[6] << 48;
+  case 6: hash ^= (uint64_t) p_bytes[5] << 40;
+  case 5: hash ^= (uint64_t) p_bytes[4] << 32;
+  case 4: hash ^= (uint64_t) p_bytes[3] << 24;
+  case 3: hash ^= (uint64_t) p_bytes[2] << 16;
+  case 2: hash ^= (uint64_t) p_bytes[1] << 8;
+  case 1: hash ^= (uint64_t) p_bytes[0];
+          hash *= m;
+  }
+
+  hash ^= hash >> r;
+  hash *= m;
+  hash ^= hash >> r;
+
+  return hash;
+}
+
 // Hashing scalars -----------------------------------------------------
 
 static uint32_t lgl_hash_scalar(const int* x);
@@ -102,6 +144,7 @@ static uint32_t lgl_hash(SEXP x);
 static uint32_t int_hash(SEXP x);
 static uint32_t dbl_hash(SEXP x);
 static uint32_t chr_hash(SEXP x);
+static uint32_t raw_hash(SEXP x);
 static uint32_t list_hash(SEXP x);
 static uint32_t node_hash(SEXP x);
 static uint32_t fn_hash(SEXP x);
@@ -136,6 +179,7 @@ static uint32_t sexp_hash(SEXP x) {
   case INTSXP: return int_hash(x);
   case REALSXP: return dbl_hash(x);
   case STRSXP: return chr_hash(x);
+  case RAWSXP: return raw_hash(x);
   case EXPRSXP:
   case VECSXP: return list_hash(x);
   case DOTSXP:
@@ -163,12 +207,6 @@ static uint32_t sexp_hash(SEXP x) {
                                                 \
   return hash
 
-static uint32_t lgl_hash(SEXP x) {
-  HASH(int, LOGICAL_RO, lgl_hash_scalar);
-}
-static uint32_t int_hash(SEXP x) {
-  HASH(int, INTEGER_RO, int_hash_scalar);
-}
 static uint32_t dbl_hash(SEXP x) {
   HASH(double, REAL_RO, dbl_hash_scalar);
 }
@@ -178,6 +216,19 @@ static uint32_t chr_hash(SEXP x) {
 
 #undef HASH
 
+// Logical, integer and raw values are equal if and only if their bytes
+// are equal, so the whole vector can be hashed at once. This makes
+// grouping by lists of small integer vectors much faster.
+static uint32_t lgl_hash(SEXP x) {
+  return hash_bytes(LOGICAL_RO(x), Rf_length(x) * sizeof(int));
+}
+static uint32_t int_hash(SEXP x) {
+  return hash_bytes(INTEGER_RO(x), Rf_length(x) * sizeof(int));
+}
+static uint32_t raw_hash(SEXP x) {
+  return hash_bytes(RAW_RO(x), Rf_length(x));
+}
+
 
 #define HASH_BARRIER(GET, HASHER)                       \
   uint32_t hash = 0;                                    \
@@ -4,6 +4,7 @@
 #include <stdbool.h> // for bool
 #include <R_ext/Rdynload.h>
 #include "altrep-rle.h"
+#include "altrep-view.h"
 #include "vctrs.h"
 
 /* FIXME:
@@ -26,10 +27,23 @@ extern SEXP vctrs_unique_loc(SEXP);
 extern SEXP vctrs_count(SEXP);
 extern SEXP vctrs_id(SEXP);
 extern SEXP vctrs_n_distinct(SEXP);
-extern SEXP vec_split(SEXP, SEXP);
+extern SEXP vctrs_split(SEXP, SEXP, SEXP);
 extern SEXP vctrs_group_id(SEXP);
 extern SEXP vctrs_group_rle(SEXP);
-extern SEXP vec_group_loc(SEXP);
+extern SEXP vctrs_group_loc(SEXP, SEXP);
+extern SEXP vctrs_group_loc_sorted(SEXP, SEXP, SEXP);
+extern SEXP vctrs_group_n(SEXP, SEXP);
+extern SEXP vctrs_group_sum(SEXP, SEXP, SEXP, SEXP);
+extern SEXP vctrs_group_mean(SEXP, SEXP, SEXP, SEXP);
+extern SEXP vctrs_group_min(SEXP, SEXP, SEXP, SEXP);
+extern SEXP vctrs_group_max(SEXP, SEXP, SEXP, SEXP);
+extern SEXP vctrs_group_first(SEXP, SEXP, SEXP);
+extern SEXP vctrs_group_last(SEXP, SEXP, SEXP);
+extern SEXP vctrs_group_n_distinct(SEXP, SEXP, SEXP);
+extern SEXP vctrs_group_seq(SEXP, SEXP);
+extern SEXP vctrs_group_cumsum(SEXP, SEXP, SEXP);
+extern SEXP vctrs_group_lag(SEXP, SEXP, SEXP, SEXP);
+extern SEXP vctrs_group_lead(SEXP, SEXP, SEXP, SEXP);
 extern SEXP vctrs_equal(SEXP, SEXP, SEXP);
 extern SEXP vctrs_equal_na(SEXP);
 extern SEXP vctrs_compare(SEXP, SEXP, SEXP);
@@ -53,6 +67,10 @@ extern SEXP vctrs_unchop(SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP vctrs_chop_seq(SEXP, SEXP, SEXP, SEXP);
 extern SEXP vec_slice_seq(SEXP, SEXP, SEXP, SEXP);
 extern SEXP vec_slice_rep(SEXP, SEXP, SEXP);
+extern SEXP vec_slice_ranges(SEXP, SEXP, SEXP);
+extern SEXP vctrs_chop_ranges(SEXP, SEXP, SEXP);
+extern SEXP vctrs_assign_ranges(SEXP, SEXP, SEXP, SEXP);
+extern SEXP vctrs_intseq_info(SEXP);
 extern SEXP vec_restore(SEXP, SEXP, SEXP);
 extern SEXP vec_restore_default(SEXP, SEXP);
 extern SEXP vec_proxy(SEXP);
@@ -97,6 +115,7 @@ extern R_len_t vec_size(SEXP);
 extern SEXP vec_init(SEXP, R_len_t);
 extern SEXP vec_assign_impl(SEXP, SEXP, SEXP);
 extern SEXP vec_slice_impl(SEXP, SEXP);
+extern SEXP vec_slice_trusted(SEXP, SEXP);
 extern SEXP vec_names(SEXP);
 extern SEXP vec_recycle(SEXP, R_len_t, struct vctrs_arg*);
 extern SEXP vec_chop(SEXP, SEXP);
@@ -114,6 +133,7 @@ SEXP vctrs_init_library(SEXP);
 
 // Defined in altrep-rle.h
 extern SEXP altrep_rle_Make(SEXP);
+extern SEXP vctrs_new_rle(SEXP, SEXP);
 void vctrs_init_altrep_rle(DllInfo* dll);
 
 static const R_CallMethodDef CallEntries[] = {
@@ -133,10 +153,23 @@ static const R_CallMethodDef CallEntries[] = {
   {"vctrs_count",                      (DL_FUNC) &vctrs_count, 1},
   {"vctrs_id",                         (DL_FUNC) &vctrs_id, 1},
   {"vctrs_n_distinct",                 (DL_FUNC) &vctrs_n_distinct, 1},
-  {"vctrs_split",                      (DL_FUNC) &vec_split, 2},
+  {"vctrs_split",                      (DL_FUNC) &vctrs_split, 3},
   {"vctrs_group_id",                   (DL_FUNC) &vctrs_group_id, 1},
   {"vctrs_group_rle",                  (DL_FUNC) &vctrs_group_rle, 1},
-  {"vctrs_group_loc",                  (DL_FUNC) &vec_group_loc, 1},
+  {"vctrs_group_loc",                  (DL_FUNC) &vctrs_group_loc, 2},
+  {"vctrs_group_loc_sorted",           (DL_FUNC) &vctrs_group_loc_sorted, 3},
+  {"vctrs_group_n",                    (DL_FUNC) &vctrs_group_n, 2},
+  {"vctrs_group_sum",                  (DL_FUNC) &vctrs_group_sum, 4},
+  {"vctrs_group_mean",                 (DL_FUNC) &vctrs_group_mean, 4},
+  {"vctrs_group_min",                  (DL_FUNC) &vctrs_group_min, 4},
+  {"vctrs_group_max",                  (DL_FUNC) &vctrs_group_max, 4},
+  {"vctrs_group_first",                (DL_FUNC) &vctrs_group_first, 3},
+  {"vctrs_group_last",                 (DL_FUNC) &vctrs_group_last, 3},
+  {"vctrs_group_n_distinct",           (DL_FUNC) &vctrs_group_n_distinct, 3},
+  {"vctrs_group_seq",                  (DL_FUNC) &vctrs_group_seq, 2},
+  {"vctrs_group_cumsum",               (DL_FUNC) &vctrs_group_cumsum, 3},
+  {"vctrs_group_lag",                  (DL_FUNC) &vctrs_group_lag, 4},
+  {"vctrs_group_lead",                 (DL_FUNC) &vctrs_group_lead, 4},
   {"vctrs_size",                       (DL_FUNC) &vctrs_size, 1},
   {"vctrs_dim",                        (DL_FUNC) &vec_dim, 1},
   {"vctrs_dim_n",                      (DL_FUNC) &vctrs_dim_n, 1},
@@ -160,6 +193,10 @@ static const R_CallMethodDef CallEntries[] = {
   {"vctrs_chop_seq",                   (DL_FUNC) &vctrs_chop_seq, 4},
   {"vctrs_slice_seq",                  (DL_FUNC) &vec_slice_seq, 4},
   {"vctrs_slice_rep",                  (DL_FUNC) &vec_slice_rep, 3},
+  {"vctrs_slice_ranges",               (DL_FUNC) &vec_slice_ranges, 3},
+  {"vctrs_chop_ranges",                (DL_FUNC) &vctrs_chop_ranges, 3},
+  {"vctrs_assign_ranges",              (DL_FUNC) &vctrs_assign_ranges, 4},
+  {"vctrs_intseq_info",                (DL_FUNC) &vctrs_intseq_info, 1},
   {"vctrs_restore",                    (DL_FUNC) &vec_restore, 3},
   {"vctrs_restore_default",            (DL_FUNC) &vec_restore_default, 2},
   {"vctrs_proxy",                      (DL_FUNC) &vec_proxy, 1},
@@ -193,6 +230,7 @@ static const R_CallMethodDef CallEntries[] = {
   {"vctrs_maybe_translate_encoding",   (DL_FUNC) &vctrs_maybe_translate_encoding, 1},
   {"vctrs_maybe_translate_encoding2",  (DL_FUNC) &vctrs_maybe_translate_encoding2, 2},
   {"vctrs_rle",                        (DL_FUNC) &altrep_rle_Make, 1},
+  {"vctrs_new_rle",                    (DL_FUNC) &vctrs_new_rle, 2},
   {"vctrs_validate_name_repair_arg",   (DL_FUNC) &vctrs_validate_name_repair_arg, 1},
   {"vctrs_validate_minimal_names",     (DL_FUNC) &vctrs_validate_minimal_names, 2},
   {"vctrs_as_names",                   (DL_FUNC) &vctrs_as_names, 3},
@@ -232,6 +270,7 @@ void R_init_vctrs(DllInfo *dll)
     R_RegisterCCallable("vctrs", "vec_restore", (DL_FUNC) &vec_restore);
     R_RegisterCCallable("vctrs", "vec_assign_impl", (DL_FUNC) &vec_assign_impl);
     R_RegisterCCallable("vctrs", "vec_slice_impl", (DL_FUNC) &vec_slice_impl);
+    R_RegisterCCallable("vctrs", "vec_slice_trusted", (DL_FUNC) &vec_slice_trusted);
     R_RegisterCCallable("vctrs", "vec_names", (DL_FUNC) &vec_names);
     R_RegisterCCallable("vctrs", "vec_set_names", (DL_FUNC) &vec_set_names);
     R_RegisterCCallable("vctrs", "vec_chop", (DL_FUNC) &vec_chop);
@@ -252,6 +291,7 @@ void R_init_vctrs(DllInfo *dll)
 
     // Altrep classes
     vctrs_init_altrep_rle(dll);
+    vctrs_init_altrep_view(dll);
 }
 
 
@@ -263,6 +303,7 @@ void vctrs_init_proxy_restore(SEXP ns);
 void vctrs_init_slice(SEXP ns);
 void vctrs_init_slice_assign(SEXP ns);
 void vctrs_init_subscript_loc(SEXP ns);
+void vctrs_init_translate(SEXP ns);
 void vctrs_init_ptype2_dispatch(SEXP ns);
 void vctrs_init_type(SEXP ns);
 void vctrs_init_type_info(SEXP ns);
@@ -278,6 +319,7 @@ SEXP vctrs_init_library(SEXP ns) {
   vctrs_init_slice(ns);
   vctrs_init_slice_assign(ns);
   vctrs_init_subscript_loc(ns);
+  vctrs_init_translate(ns);
   vctrs_init_ptype2_dispatch(ns);
   vctrs_init_type(ns);
   vctrs_init_type_info(ns);
@@ -0,0 +1,368 @@
+#include "vctrs.h"
+#include "utils.h"
+
+// Stable ordering of comparison proxies
+//
+// Integers, logicals and doubles are mapped to unsigned keys that sort
+// in the same order as the values, and are then ordered with a least
+// significant digit radix sort on bytes. Strings are ordered with a
+// merge sort on their bytes, so `x` must have been translated to a
+// common encoding beforehand. Data frames and arrays are ordered column
+// by column, from last to first, which is valid because each pass is
+// stable.
+//
+// Missing values are ordered last. For doubles, `NaN` is ordered
+// before `NA`.
+
+struct order_buffers {
+  uint64_t* p_keys;
+  uint64_t* p_keys_aux;
+  int* p_o_aux;
+};
+
+static void col_order(SEXP x, R_len_t n, int* p_o, struct order_buffers* p_buf);
+
+/**
+ * Fill `p_o` with the 0-based stable ordering of `x`
+ *
+ * @param x A comparison proxy, with strings translated to UTF-8.
+ * @param n The size of `x`.
+ */
+// [[ include("vctrs.h") ]]
+void proxy_order_fill(SEXP x, R_len_t n, int* p_o) {
+  for (R_len_t i = 0; i < n; ++i) {
+    p_o[i] = i;
+  }
+
+  if (n < 2) {
+    return;
+  }
+
+  struct order_buffers buf = {
+    .p_keys = (uint64_t*) R_alloc(n, sizeof(uint64_t)),
+    .p_keys_aux = (uint64_t*) R_alloc(n, sizeof(uint64_t)),
+    .p_o_aux = (int*) R_alloc(n, sizeof(int))
+  };
+
+  col_order(x, n, p_o, &buf);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline uint64_t int_order_key(int x) {
+  if (x == NA_INTEGER) {
+    return UINT32_MAX;
+  }
+
+  // `INT_MIN` is `NA`, so flipping the sign bit maps the other values
+  // to `[1, UINT32_MAX]`
+  return ((uint32_t) x ^ UINT32_C(0x80000000)) - 1;
+}
+
+static inline uint64_t dbl_order_key(double x) {
+  switch (dbl_classify(x)) {
+  case vctrs_dbl_number: break;
+  case vctrs_dbl_nan: return UINT64_MAX - 1;
+  case vctrs_dbl_missing: return UINT64_MAX;
+  }
+
+  // Treat positive/negative 0 as equivalent
+  if (x == 0.0) {
+    x = 0.0;
+  }
+
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(uint64_t));
+
+  // Negative values are ordered by decreasing magnitude
+  const uint64_t sign = UINT64_C(1) << 63;
+  return (bits & sign) ? ~bits : bits | sign;
+}
+
+// Order `p_o` by the first `n_bytes` bytes of the keys, which are
+// parallel to `p_o`
+static void radix_order(int* p_o, R_len_t n, int n_bytes, struct order_buffers* p_buf) {
+  uint64_t* p_keys = p_buf->p_keys;
+  uint64_t* p_keys_aux = p_buf->p_keys_aux;
+  int* p_o_out = p_o;
+  int* p_o_aux = p_buf->p_o_aux;
+
+  R_len_t counts[256];
+
+  for (int byte = 0; byte < n_bytes; ++byte) {
+    int shift = byte * 8;
+
+    memset(counts, 0, sizeof(counts));
+
+    for (R_len_t i = 0; i < n; ++i) {
+      ++counts[(p_keys[i] >> shift) & 0xFF];
+    }
+
+    // Skip bytes that are identical for all keys
+    if (counts[(p_keys[0] >> shift) & 0xFF] == n) {
+      continue;
+    }
+
+    R_len_t pos = 0;
+    for (int digit = 0; digit < 256; ++digit) {
+      R_len_t count = counts[digit];
+      counts[digit] = pos;
+      pos += count;
+    }
+
+    for (R_len_t i = 0; i < n; ++i) {
+      R_len_t j = counts[(p_keys[i] >> shift) & 0xFF]++;
+      p_keys_aux[j] = p_keys[i];
+      p_o_aux[j] = p_o[i];
+    }
+
+    uint64_t* p_keys_tmp = p_keys;
+    p_keys = p_keys_aux;
+    p_keys_aux = p_keys_tmp;
+
+    int* p_o_tmp = p_o;
+    p_o = p_o_aux;
+    p_o_aux = p_o_tmp;
+  }
+
+  if (p_o != p_o_out) {
+    memcpy(p_o_out, p_o, n * sizeof(int));
+  }
+}
+
+static void int_order(const int* p_x, R_len_t n, int* p_o, struct order_buffers* p_buf) {
+  uint64_t* p_keys = p_buf->p_keys;
+
+  for (R_len_t i = 0; i < n; ++i) {
+    p_keys[i] = int_order_key(p_x[p_o[i]]);
+  }
+
+  radix_order(p_o, n, 4, p_buf);
+}
+
+static void dbl_order(const double* p_x, R_len_t n, int* p_o, struct order_buffers* p_buf) {
+  uint64_t* p_keys = p_buf->p_keys;
+
+  for (R_len_t i = 0; i < n; ++i) {
+    p_keys[i] = dbl_order_key(p_x[p_o[i]]);
+  }
+
+  radix_order(p_o, n, 8, p_buf);
+}
+
+static inline int chr_order_cmp(SEXP x, SEXP y) {
+  if (x == y) {
+    return 0;
+  }
+  if (x == NA_STRING) {
+    return 1;
+  }
+  if (y == NA_STRING) {
+    return -1;
+  }
+  return strcmp(CHAR(x), CHAR(y));
+}
+
+// Bottom-up merge sort, which is stable
+static void chr_order(const SEXP* p_x, R_len_t n, int* p_o, struct order_buffers* p_buf) {
+  int* p_o_out = p_o;
+  int* p_o_aux = p_buf->p_o_aux;
+
+  for (R_len_t width = 1; width < n; width *= 2) {
+    for (R_len_t lo = 0; lo < n; lo += 2 * width) {
+      R_len_t mid = lo + width;
+      R_len_t hi = lo + 2 * width;
+
+      mid = (mid < n) ? mid : n;
+      hi = (hi < n) ? hi : n;
+
+      R_len_t i = lo;
+      R_len_t j = mid;
+      R_len_t k = lo;
+
+      while (i < mid && j < hi) {
+        if (chr_order_cmp(p_x[p_o[j]], p_x[p_o[i]]) < 0) {
+          p_o_aux[k++] = p_o[j++];
+        } else {
+          p_o_aux[k++] = p_o[i++];
+        }
+      }
+      while (i < mid) {
+        p_o_aux[k++] = p_o[i++];
+      }
+      while (j < hi) {
+        p_o_aux[k++] = p_o[j++];
+      }
+    }
+
+    int* p_o_tmp = p_o;
+    p_o = p_o_aux;
+    p_o_aux = p_o_tmp;
+  }
+
+  if (p_o != p_o_out) {
+    memcpy(p_o_out, p_o, n * sizeof(int));
+  }
+}
+
+// Orders the `n` elements of `x` starting at `offset`
+static void atomic_order(SEXP x, R_xlen_t offset, R_len_t n, int* p_o, struct order_buffers* p_buf) {
+  switch (TYPEOF(x)) {
+  case LGLSXP: int_order(LOGICAL_RO(x) + offset, n, p_o, p_buf); return;
+  case INTSXP: int_order(INTEGER_RO(x) + offset, n, p_o, p_buf); return;
+  case REALSXP: dbl_order(REAL_RO(x) + offset, n, p_o, p_buf); return;
+  case STRSXP: chr_order(STRING_PTR_RO(x) + offset, n, p_o, p_buf); return;
+  default: Rf_errorcall(R_NilValue, "Internal error: Unexpected type in `atomic_order()`.");
+  }
+}
+
+static void col_order(SEXP x, R_len_t n, int* p_o, struct order_buffers* p_buf) {
+  switch (TYPEOF(x)) {
+  case LGLSXP:
+  case INTSXP:
+  case REALSXP:
+  case STRSXP: {
+    // Arrays are compared row-wise. Like data frames, their columns
+    // are ordered from last to first.
+    R_xlen_t n_col = Rf_xlength(x) / n;
+    for (R_xlen_t i = n_col - 1; i >= 0; --i) {
+      atomic_order(x, i * n, n, p_o, p_buf);
+    }
+    return;
+  }
+  case VECSXP: {
+    if (is_data_frame(x)) {
+      for (R_len_t i = Rf_length(x) - 1; i >= 0; --i) {
+        col_order(VECTOR_ELT(x, i), n, p_o, p_buf);
+      }
+      return;
+    }
+    Rf_errorcall(R_NilValue, "Can't sort lists.");
+  }
+  default:
+    Rf_errorcall(R_NilValue, "Can't sort vectors of type %s.", Rf_type2char(TYPEOF(x)));
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+static inline int int_monotonic_cmp(int x, int y) {
+  return (x > y) - (x < y);
+}
+
+// Numbers are ordered before `NaN`, which is ordered before `NA`, so
+// that the missing values of a monotonic vector are contiguous
+static inline int dbl_monotonic_cmp(double x, double y) {
+  enum vctrs_dbl_class x_class = dbl_classify(x);
+  enum vctrs_dbl_class y_class = dbl_classify(y);
+
+  if (x_class != vctrs_dbl_number || y_class != vctrs_dbl_number) {
+    int x_rank = (x_class == vctrs_dbl_number) ? 0 : (x_class == vctrs_dbl_nan) ? 1 : 2;
+    int y_rank = (y_class == vctrs_dbl_number) ? 0 : (y_class == vctrs_dbl_nan) ? 1 : 2;
+    return (x_rank > y_rank) - (x_rank < y_rank);
+  }
+
+  return (x > y) - (x < y);
+}
+
+static bool col_is_monotonic_type(SEXP x) {
+  // Arrays are compared row-wise
+  if (has_dim(x)) {
+    return false;
+  }
+
+  switch (TYPEOF(x)) {
+  case LGLSXP:
+  case INTSXP:
+  case REALSXP:
+    return true;
+  case VECSXP:
+    if (!is_data_frame(x)) {
+      return false;
+    }
+    for (R_len_t i = 0; i < Rf_length(x); ++i) {
+      if (!col_is_monotonic_type(VECTOR_ELT(x, i))) {
+        return false;
+      }
+    }
+    return true;
+  default:
+    return false;
+  }
+}
+
+static int col_monotonic_cmp(SEXP x, R_len_t i, R_len_t j) {
+  switch (TYPEOF(x)) {
+  case LGLSXP: return int_monotonic_cmp(LOGICAL_RO(x)[i], LOGICAL_RO(x)[j]);
+  case INTSXP: return int_monotonic_cmp(INTEGER_RO(x)[i], INTEGER_RO(x)[j]);
+  case REALSXP: return dbl_monotonic_cmp(REAL_RO(x)[i], REAL_RO(x)[j]);
+  default: {
+    for (R_len_t k = 0; k < Rf_length(x); ++k) {
+      int cmp = col_monotonic_cmp(VECTOR_ELT(x, k), i, j);
+      if (cmp) {
+        return cmp;
+      }
+    }
+    return 0;
+  }
+  }
+}
+
+static bool col_is_known_sorted(SEXP x) {
+#if (R_VERSION >= R_Version(3, 5, 0))
+  switch (TYPEOF(x)) {
+  case INTSXP: return KNOWN_SORTED(INTEGER_IS_SORTED(x));
+  // R doesn't distinguish `NA` from `NaN` when sorting doubles, so
+  // the sortedness flag can only be trusted without missing values
+  case REALSXP: return KNOWN_SORTED(REAL_IS_SORTED(x)) && REAL_NO_NA(x);
+  default: return false;
+  }
+#else
+  return false;
+#endif
+}
+
+/**
+ * Is `x` monotonic?
+ *
+ * When a proxy is sorted, in increasing or decreasing order, equal
+ * values are contiguous. Each run of equal values is then a distinct
+ * group, which can be identified without hashing. This is checked
+ * with the ALTREP sortedness flag if available, and with a linear
+ * scan otherwise. The scan stops at the first element out of order,
+ * so it is cheap for unsorted inputs.
+ *
+ * Only logical, integer and double proxies, and data frames of such
+ * columns, are checked. Other types, including arrays, are never
+ * considered monotonic.
+ *
+ * @param x An equality proxy.
+ * @param n The size of `x`.
+ */
+// [[ include("vctrs.h") ]]
+bool proxy_is_monotonic(SEXP x, R_len_t n) {
+  if (!col_is_monotonic_type(x)) {
+    return false;
+  }
+
+  if (col_is_known_sorted(x)) {
+    return true;
+  }
+
+  int direction = 0;
+
+  for (R_len_t i = 1; i < n; ++i) {
+    int cmp = col_monotonic_cmp(x, i - 1, i);
+
+    if (cmp == 0) {
+      continue;
+    }
+    if (direction == 0) {
+      direction = cmp;
+    } else if (cmp != direction) {
+      return false;
+    }
+  }
+
+  return true;
+}
@@ -2,88 +2,48 @@
 #include "utils.h"
 
 /*
- * Array slicing works by treating the array as a 1D structure, and transforming
- * the `index` passed from R into a series of 1D indices that are used to
- * extract elements from `x` into the new result.
+ * Array slicing works by treating the array as a 2D structure. Arrays
+ * are stored in column major order, so an array of dimensions
+ * (d1, d2, ..., dn) is laid out in memory as `d2 * ... * dn` columns
+ * of `d1` contiguous elements. Slicing an array along its first
+ * dimension means slicing each of these columns with the same
+ * `index`, and the sliced columns are laid out one after another in
+ * the result.
  *
- * Strides represent the offset between elements in the same dimension. For
- * a (2, 2, 2) array, the strides would be [1, 2, 4]. This means that if you
- * flattened this 3D array to 1D in a column major order, there is 1 space
- * between row elements, 2 spaces between column elements and 4 spaces between
- * elements in the third dimension. In practice, we only need the shape strides
- * since the first stride is always 1, so `vec_strides()` only returns the shape
- * strides. Strides are computed as a cumulative product of the `dim`, with an
- * initial value of `1`, this is what `vec_strides()` does.
- *
- * Using the strides, any array index can be converted to a 1D index.
- * This is what `vec_strided_loc()` does. In a (2, 2, 2) array, to find
- * the location at the index [1, 0, 1] (C-based index, 2nd row, 1st col,
- * 2nd elem in 3rd dim) you compute a sum product between the array index
- * and the strides. So it looks like:
- * loc = 1 * (1) + 0 * (2) + 1 * (4) = 5
- * (loc is a C-based index into `x`)
- * Since the first stride is always one, we leave it off and just do:
- * loc = 1 + 0 * (2) + 1 * (4) = 5
+ * Column `i` starts at location `i * d1` in `x`, and row `j` of that
+ * column is at location `i * d1 + j`. This is also what you get when
+ * computing the sum product of an array index with the strides of
+ * the array, since the columns are enumerated in column major order.
  *
  * Example:
  * x = (3, 3, 2) array
  * vec_slice(x, 2:3)
  *
- * strides = [3, 9] // (shape strides)
+ * Indices are C-based. There are 3 * 2 = 6 columns of size 3.
  *
- * Indices are C-based
+ *         | array index | column | x index | how?
+ * ---------------------------------------------------
+ * out[0]  | [1, 0, 0]   | 0      | 1       | 0 * 3 + 1
+ * out[1]  | [2, 0, 0]   | 0      | 2       | 0 * 3 + 2
+ * out[2]  | [1, 1, 0]   | 1      | 4       | 1 * 3 + 1
+ * ...     | ...         | ...    | ...     | ...
+ * out[9]  | [2, 1, 1]   | 4      | 14      | 4 * 3 + 2
+ * out[10] | [1, 2, 1]   | 5      | 16      | 5 * 3 + 1
+ * out[11] | [2, 2, 1]   | 5      | 17      | 5 * 3 + 2
  *
- *         | array index | x index | how?
- * -------------------------------------------------------
- * out[0]  | [1, 0, 0]   | 1       | 1 + 0 * (3) + 0 * (9)
- * out[1]  | [2, 0, 0]   | 2       |
- * out[2]  | [1, 1, 0]   | 4       |
- * ...     | ...         | ...     |
- * out[9]  | [2, 1, 1]   | 14      | 2 + 1 * (3) + 1 * (9)
- * out[10] | [1, 2, 1]   | 16      |
- * out[11] | [2, 2, 1]   | 17      |
- *            ^  ^  ^
- *            |   \/
- *            |    |- shape_index
- *            |- size_index
+ * Each column is sliced with a tight loop over the index. Compact
+ * sequences with a step of 1 and compact ranges are copied with one
+ * `memcpy()` per column and range.
  */
 
-static SEXP vec_strides(const int* p_dim, const R_len_t shape_n) {
-  SEXP strides = PROTECT(Rf_allocVector(INTSXP, shape_n));
-  int* p_strides = INTEGER(strides);
-  int stride = 1;
-
-  for (int i = 0; i < shape_n; ++i) {
-    stride *= p_dim[i];
-    p_strides[i] = stride;
-  }
-
-  UNPROTECT(1);
-  return strides;
-}
-
-static int vec_strided_loc(const int size_index,
-                           const int* p_shape_index,
-                           const int* p_strides,
-                           const R_len_t shape_n) {
-  int loc = size_index;
-  for (R_len_t i = 0; i < shape_n; ++i) {
-    loc += p_strides[i] * p_shape_index[i];
-  }
-  return loc;
-}
-
 // To keep the #define as compact as possible, we use a struct to pass around
 // important information.
 struct vec_slice_shaped_info {
-  const int* p_dim;
-  const int* p_strides;
   const int* p_index;
-  int* p_shape_index;
-  R_len_t dim_n;
-  R_len_t shape_n;
   R_len_t index_n;
-  R_len_t shape_elem_n;
+  R_len_t col_size;
+  R_xlen_t col_n;
+  bool index_na;
   SEXP out_dim;
 };
 
@@ -92,117 +52,106 @@ struct vec_slice_shaped_info {
   CTYPE* out_data = DEREF(out);                                        \
   const CTYPE* x_data = CONST_DEREF(x);                                \
                                                                        \
-  for (int i = 0; i < info.shape_elem_n; ++i) {                        \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                          \
+    const CTYPE* col_data = x_data + i * info.col_size;                \
                                                                        \
-    /* Find and add the next `x` element */                            \
-    for (int j = 0; j < info.index_n; ++j, ++out_data) {               \
-      int size_index = info.p_index[j];                                \
+    if (!info.index_na) {                                              \
+      for (R_len_t j = 0; j < info.index_n; ++j, ++out_data) {         \
+        *out_data = col_data[info.p_index[j] - 1];                     \
+      }                                                                \
+      continue;                                                        \
+    }                                                                  \
                                                                        \
+    for (R_len_t j = 0; j < info.index_n; ++j, ++out_data) {           \
+      int size_index = info.p_index[j];                                \
       if (size_index == NA_INTEGER) {                                  \
         *out_data = NA_VALUE;                                          \
       } else {                                                         \
-        int loc = vec_strided_loc(                                     \
-          size_index - 1,                                              \
-          info.p_shape_index,                                          \
-          info.p_strides,                                              \
-          info.shape_n                                                 \
-        );                                                             \
-        *out_data = x_data[loc];                                       \
-      }                                                                \
-    }                                                                  \
-                                                                       \
-    /* Update shape_index */                                           \
-    for (int j = 0; j < info.shape_n; ++j) {                           \
-      info.p_shape_index[j]++;                                         \
-      if (info.p_shape_index[j] < info.p_dim[j + 1]) {                 \
-        break;                                                         \
+        *out_data = col_data[size_index - 1];                          \
       }                                                                \
-      info.p_shape_index[j] = 0;                                       \
     }                                                                  \
   }                                                                    \
                                                                        \
   UNPROTECT(1);                                                        \
   return out
 
-#define SLICE_SHAPED_COMPACT_REP(RTYPE, CTYPE, DEREF, CONST_DEREF, NA_VALUE)   \
-  SEXP out = PROTECT(Rf_allocArray(RTYPE, info.out_dim));                      \
-  CTYPE* out_data = DEREF(out);                                                \
-                                                                               \
-  int size_index = info.p_index[0];                                            \
-  if (size_index == NA_INTEGER) {                                              \
-    R_len_t out_n = info.shape_elem_n * info.index_n;                          \
-    for (int i = 0; i < out_n; ++i, ++out_data) {                              \
-      *out_data = NA_VALUE;                                                    \
-    }                                                                          \
-    UNPROTECT(1);                                                              \
-    return(out);                                                               \
-  }                                                                            \
-                                                                               \
-  const CTYPE* x_data = CONST_DEREF(x);                                        \
-                                                                               \
-  /* Convert to C index */                                                     \
-  size_index = size_index - 1;                                                 \
-                                                                               \
-  for (int i = 0; i < info.shape_elem_n; ++i) {                                \
-                                                                               \
-    /* Find and add the next `x` element */                                    \
-    for (int j = 0; j < info.index_n; ++j, ++out_data) {                       \
-      int loc = vec_strided_loc(                                               \
-        size_index,                                                            \
-        info.p_shape_index,                                                    \
-        info.p_strides,                                                        \
-        info.shape_n                                                           \
-      );                                                                       \
-      *out_data = x_data[loc];                                                 \
-    }                                                                          \
-                                                                               \
-    /* Update shape_index */                                                   \
-    for (int j = 0; j < info.shape_n; ++j) {                                   \
-      info.p_shape_index[j]++;                                                 \
-      if (info.p_shape_index[j] < info.p_dim[j + 1]) {                         \
-        break;                                                                 \
-      }                                                                        \
-      info.p_shape_index[j] = 0;                                               \
-    }                                                                          \
-  }                                                                            \
-                                                                               \
-  UNPROTECT(1);                                                                \
+#define SLICE_SHAPED_COMPACT_REP(RTYPE, CTYPE, DEREF, CONST_DEREF, NA_VALUE) \
+  SEXP out = PROTECT(Rf_allocArray(RTYPE, info.out_dim));                    \
+  CTYPE* out_data = DEREF(out);                                              \
+                                                                             \
+  int size_index = info.p_index[0];                                          \
+  if (size_index == NA_INTEGER) {                                            \
+    R_xlen_t out_n = info.col_n * info.index_n;                              \
+    for (R_xlen_t i = 0; i < out_n; ++i, ++out_data) {                       \
+      *out_data = NA_VALUE;                                                  \
+    }                                                                        \
+    UNPROTECT(1);                                                            \
+    return(out);                                                             \
+  }                                                                          \
+                                                                             \
+  const CTYPE* x_data = CONST_DEREF(x);                                      \
+                                                                             \
+  /* Convert to C index */                                                   \
+  size_index = size_index - 1;                                               \
+                                                                             \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                                \
+    CTYPE elt = x_data[i * info.col_size + size_index];                      \
+    for (R_len_t j = 0; j < info.index_n; ++j, ++out_data) {                 \
+      *out_data = elt;                                                       \
+    }                                                                        \
+  }                                                                          \
+                                                                             \
+  UNPROTECT(1);                                                              \
+  return out
+
+#define SLICE_SHAPED_COMPACT_SEQ(RTYPE, CTYPE, DEREF, CONST_DEREF)     \
+  SEXP out = PROTECT(Rf_allocArray(RTYPE, info.out_dim));              \
+  CTYPE* out_data = DEREF(out);                                        \
+                                                                       \
+  R_len_t start = info.p_index[0];                                     \
+  R_len_t n = info.p_index[1];                                         \
+  R_len_t step = info.p_index[2];                                      \
+                                                                       \
+  const CTYPE* x_data = CONST_DEREF(x);                                \
+                                                                       \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                          \
+    const CTYPE* col_data = x_data + i * info.col_size + start;        \
+                                                                       \
+    if (step == 1) {                                                   \
+      memcpy(out_data, col_data, n * sizeof(CTYPE));                   \
+      out_data += n;                                                   \
+      continue;                                                        \
+    }                                                                  \
+                                                                       \
+    for (R_len_t j = 0; j < n; ++j, ++out_data, col_data += step) {    \
+      *out_data = *col_data;                                           \
+    }                                                                  \
+  }                                                                    \
+                                                                       \
+  UNPROTECT(1);                                                        \
   return out
 
-#define SLICE_SHAPED_COMPACT_SEQ(RTYPE, CTYPE, DEREF, CONST_DEREF)                    \
-  SEXP out = PROTECT(Rf_allocArray(RTYPE, info.out_dim));                             \
-  CTYPE* out_data = DEREF(out);                                                       \
-                                                                                      \
-  R_len_t start = info.p_index[0];                                                    \
-  R_len_t n = info.p_index[1];                                                        \
-  R_len_t step = info.p_index[2];                                                     \
-                                                                                      \
-  const CTYPE* x_data = CONST_DEREF(x);                                               \
-                                                                                      \
-  for (int i = 0; i < info.shape_elem_n; ++i) {                                       \
-                                                                                      \
-    /* Find and add the next `x` element */                                           \
-    for (int j = 0, size_index = start; j < n; ++j, size_index += step, ++out_data) { \
-      int loc = vec_strided_loc(                                                      \
-        size_index,                                                                   \
-        info.p_shape_index,                                                           \
-        info.p_strides,                                                               \
-        info.shape_n                                                                  \
-      );                                                                              \
-      *out_data = x_data[loc];                                                        \
-    }                                                                                 \
-                                                                                      \
-    /* Update shape_index */                                                          \
-    for (int j = 0; j < info.shape_n; ++j) {                                          \
-      info.p_shape_index[j]++;                                                        \
-      if (info.p_shape_index[j] < info.p_dim[j + 1]) {                                \
-        break;                                                                        \
-      }                                                                               \
-      info.p_shape_index[j] = 0;                                                      \
-    }                                                                                 \
-  }                                                                                   \
-                                                                                      \
-  UNPROTECT(1);                                                                       \
+#define SLICE_SHAPED_COMPACT_RANGES(RTYPE, CTYPE, DEREF, CONST_DEREF)  \
+  SEXP out = PROTECT(Rf_allocArray(RTYPE, info.out_dim));              \
+  CTYPE* out_data = DEREF(out);                                        \
+                                                                       \
+  R_len_t n_ranges = info.p_index[0];                                  \
+  const int* p_starts = info.p_index + 2;                              \
+  const int* p_sizes = info.p_index + 2 + n_ranges;                    \
+                                                                       \
+  const CTYPE* x_data = CONST_DEREF(x);                                \
+                                                                       \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                          \
+    const CTYPE* col_data = x_data + i * info.col_size;                \
+                                                                       \
+    for (R_len_t j = 0; j < n_ranges; ++j) {                           \
+      R_len_t size = p_sizes[j];                                       \
+      memcpy(out_data, col_data + p_starts[j], size * sizeof(CTYPE));  \
+      out_data += size;                                                \
+    }                                                                  \
+  }                                                                    \
+                                                                       \
+  UNPROTECT(1);                                                        \
   return out
 
 #define SLICE_SHAPED(RTYPE, CTYPE, DEREF, CONST_DEREF, NA_VALUE)          \
@@ -210,6 +159,8 @@ struct vec_slice_shaped_info {
     SLICE_SHAPED_COMPACT_REP(RTYPE, CTYPE, DEREF, CONST_DEREF, NA_VALUE); \
   } else if (is_compact_seq(index)) {                                     \
     SLICE_SHAPED_COMPACT_SEQ(RTYPE, CTYPE, DEREF, CONST_DEREF);           \
+  } else if (is_compact_ranges(index)) {                                  \
+    SLICE_SHAPED_COMPACT_RANGES(RTYPE, CTYPE, DEREF, CONST_DEREF);        \
   } else {                                                                \
     SLICE_SHAPED_INDEX(RTYPE, CTYPE, DEREF, CONST_DEREF, NA_VALUE);       \
   }
@@ -236,40 +187,25 @@ static SEXP raw_slice_shaped(SEXP x, SEXP index, struct vec_slice_shaped_info in
 #undef SLICE_SHAPED
 #undef SLICE_SHAPED_COMPACT_REP
 #undef SLICE_SHAPED_COMPACT_SEQ
+#undef SLICE_SHAPED_COMPACT_RANGES
 #undef SLICE_SHAPED_INDEX
 
 #define SLICE_BARRIER_SHAPED_INDEX(RTYPE, GET, SET, NA_VALUE)  \
   SEXP out = PROTECT(Rf_allocArray(RTYPE, info.out_dim));      \
                                                                \
-  int out_loc = 0;                                             \
+  R_xlen_t out_loc = 0;                                        \
                                                                \
-  for (int i = 0; i < info.shape_elem_n; ++i) {                \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                  \
+    R_xlen_t col_loc = i * info.col_size;                      \
                                                                \
-    /* Find and add the next `x` element */                    \
-    for (int j = 0; j < info.index_n; ++j, ++out_loc) {        \
+    for (R_len_t j = 0; j < info.index_n; ++j, ++out_loc) {    \
       int size_index = info.p_index[j];                        \
                                                                \
       if (size_index == NA_INTEGER) {                          \
         SET(out, out_loc, NA_VALUE);                           \
       } else {                                                 \
-        int loc = vec_strided_loc(                             \
-          size_index - 1,                                      \
-          info.p_shape_index,                                  \
-          info.p_strides,                                      \
-          info.shape_n                                         \
-        );                                                     \
-        SEXP elt = GET(x, loc);                                \
-        SET(out, out_loc, elt);                                \
-      }                                                        \
-    }                                                          \
-                                                               \
-    /* Update shape_index */                                   \
-    for (int j = 0; j < info.shape_n; ++j) {                   \
-      info.p_shape_index[j]++;                                 \
-      if (info.p_shape_index[j] < info.p_dim[j + 1]) {         \
-        break;                                                 \
+        SET(out, out_loc, GET(x, col_loc + size_index - 1));   \
       }                                                        \
-      info.p_shape_index[j] = 0;                               \
     }                                                          \
   }                                                            \
                                                                \
@@ -281,80 +217,72 @@ static SEXP raw_slice_shaped(SEXP x, SEXP index, struct vec_slice_shaped_info in
                                                                       \
   int size_index = info.p_index[0];                                   \
   if (size_index == NA_INTEGER) {                                     \
-    R_len_t out_n = info.shape_elem_n * info.index_n;                 \
-    for (int i = 0; i < out_n; ++i) {                                 \
+    R_xlen_t out_n = info.col_n * info.index_n;                       \
+    for (R_xlen_t i = 0; i < out_n; ++i) {                            \
       SET(out, i, NA_VALUE);                                          \
     }                                                                 \
     UNPROTECT(1);                                                     \
     return(out);                                                      \
   }                                                                   \
                                                                       \
-  int out_loc = 0;                                                    \
+  R_xlen_t out_loc = 0;                                               \
                                                                       \
   /* Convert to C index */                                            \
   size_index = size_index - 1;                                        \
                                                                       \
-  for (int i = 0; i < info.shape_elem_n; ++i) {                       \
-                                                                      \
-    /* Find and add the next `x` element */                           \
-    for (int j = 0; j < info.index_n; ++j, ++out_loc) {               \
-      int loc = vec_strided_loc(                                      \
-        size_index,                                                   \
-        info.p_shape_index,                                           \
-        info.p_strides,                                               \
-        info.shape_n                                                  \
-      );                                                              \
-      SEXP elt = GET(x, loc);                                         \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                         \
+    SEXP elt = GET(x, i * info.col_size + size_index);                \
+    for (R_len_t j = 0; j < info.index_n; ++j, ++out_loc) {           \
       SET(out, out_loc, elt);                                         \
-    }                                                                 \
-                                                                      \
-    /* Update shape_index */                                          \
-    for (int j = 0; j < info.shape_n; ++j) {                          \
-      info.p_shape_index[j]++;                                        \
-      if (info.p_shape_index[j] < info.p_dim[j + 1]) {                \
-        break;                                                        \
-      }                                                               \
-      info.p_shape_index[j] = 0;                                      \
     }                                                                 \
   }                                                                   \
                                                                       \
   UNPROTECT(1);                                                       \
   return out
 
-#define SLICE_BARRIER_SHAPED_COMPACT_SEQ(RTYPE, GET, SET)                            \
-  SEXP out = PROTECT(Rf_allocArray(RTYPE, info.out_dim));                            \
-                                                                                     \
-  R_len_t start = info.p_index[0];                                                   \
-  R_len_t n = info.p_index[1];                                                       \
-  R_len_t step = info.p_index[2];                                                    \
-                                                                                     \
-  int out_loc = 0;                                                                   \
-                                                                                     \
-  for (int i = 0; i < info.shape_elem_n; ++i) {                                      \
-                                                                                     \
-    /* Find and add the next `x` element */                                          \
-    for (int j = 0, size_index = start; j < n; ++j, size_index += step, ++out_loc) { \
-      int loc = vec_strided_loc(                                                     \
-        size_index,                                                                  \
-        info.p_shape_index,                                                          \
-        info.p_strides,                                                              \
-        info.shape_n                                                                 \
-      );                                                                             \
-      SEXP elt = GET(x, loc);                                                        \
-      SET(out, out_loc, elt);                                                        \
-    }                                                                                \
-                                                                                     \
-    /* Update shape_index */                                                         \
-    for (int j = 0; j < info.shape_n; ++j) {                                         \
-      info.p_shape_index[j]++;                                                       \
-      if (info.p_shape_index[j] < info.p_dim[j + 1]) {                               \
-        break;                                                                       \
-      }                                                                              \
-      info.p_shape_index[j] = 0;                                                     \
-    }                                                                                \
-  }                                                                                  \
-                                                                                     \
-  UNPROTECT(1);                                                                      \
+#define SLICE_BARRIER_SHAPED_COMPACT_SEQ(RTYPE, GET, SET)                  \
+  SEXP out = PROTECT(Rf_allocArray(RTYPE, info.out_dim));                  \
+                                                                           \
+  R_len_t start = info.p_index[0];                                         \
+  R_len_t n = info.p_index[1];                                             \
+  R_len_t step = info.p_index[2];                                          \
+                                                                           \
+  R_xlen_t out_loc = 0;                                                    \
+                                                                           \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                              \
+    R_xlen_t loc = i * info.col_size + start;                              \
+                                                                           \
+    for (R_len_t j = 0; j < n; ++j, loc += step, ++out_loc) {              \
+      SET(out, out_loc, GET(x, loc));                                      \
+    }                                                                      \
+  }                                                                        \
+                                                                           \
+  UNPROTECT(1);                                                            \
+  return out
+
+#define SLICE_BARRIER_SHAPED_COMPACT_RANGES(RTYPE, GET, SET)               \
+  SEXP out = PROTECT(Rf_allocArray(RTYPE, info.out_dim));                  \
+                                                                           \
+  R_len_t n_ranges = info.p_index[0];                                      \
+  const int* p_starts = info.p_index + 2;                                  \
+  const int* p_sizes = info.p_index + 2 + n_ranges;                        \
+                                                                           \
+  R_xlen_t out_loc = 0;                                                    \
+                                                                           \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                              \
+    R_xlen_t col_loc = i * info.col_size;                                  \
+                                                                           \
+    for (R_len_t j = 0; j < n_ranges; ++j) {                               \
+      R_xlen_t loc = col_loc + p_starts[j];                                \
+      R_xlen_t end = loc + p_sizes[j];                                     \
+                                                                           \
+      for (; loc < end; ++loc, ++out_loc) {                                \
+        SET(out, out_loc, GET(x, loc));                                    \
+      }                                                                    \
+    }                                                                      \
+  }                                                                        \
+                                                                           \
+  UNPROTECT(1);                                                            \
   return out
 
 #define SLICE_BARRIER_SHAPED(RTYPE, GET, SET, NA_VALUE)          \
@@ -362,6 +290,8 @@ static SEXP raw_slice_shaped(SEXP x, SEXP index, struct vec_slice_shaped_info in
     SLICE_BARRIER_SHAPED_COMPACT_REP(RTYPE, GET, SET, NA_VALUE); \
   } else if (is_compact_seq(index)) {                            \
     SLICE_BARRIER_SHAPED_COMPACT_SEQ(RTYPE, GET, SET);           \
+  } else if (is_compact_ranges(index)) {                         \
+    SLICE_BARRIER_SHAPED_COMPACT_RANGES(RTYPE, GET, SET);        \
   } else {                                                       \
     SLICE_BARRIER_SHAPED_INDEX(RTYPE, GET, SET, NA_VALUE);       \
   }
@@ -373,6 +303,7 @@ static SEXP list_slice_shaped(SEXP x, SEXP index, struct vec_slice_shaped_info i
 #undef SLICE_BARRIER_SHAPED
 #undef SLICE_BARRIER_SHAPED_COMPACT_REP
 #undef SLICE_BARRIER_SHAPED_COMPACT_SEQ
+#undef SLICE_BARRIER_SHAPED_COMPACT_RANGES
 #undef SLICE_BARRIER_SHAPED_INDEX
 
 SEXP vec_slice_shaped_base(enum vctrs_type type,
@@ -395,36 +326,213 @@ SEXP vec_slice_shaped_base(enum vctrs_type type,
 SEXP vec_slice_shaped(enum vctrs_type type, SEXP x, SEXP index) {
 
   SEXP dim = PROTECT(vec_dim(x));
+  const int* p_dim = INTEGER_RO(dim);
+  R_len_t dim_n = Rf_length(dim);
 
   struct vec_slice_shaped_info info;
-  info.p_dim = INTEGER_RO(dim);
   info.p_index = INTEGER_RO(index);
-  info.dim_n = Rf_length(dim);
-  info.shape_n = info.dim_n - 1;
   info.index_n = vec_subscript_size(index);
+  info.col_size = p_dim[0];
 
-  SEXP strides = PROTECT(vec_strides(info.p_dim, info.shape_n));
-  info.p_strides = INTEGER_RO(strides);
+  // Compact subscripts are checked for `NA` by their own kernels
+  info.index_na = !is_compact(index) && r_int_any_na(index);
 
   // `out_dim` has the same shape as `x`, with an altered size
   // corresponding to the length of the `index`
   info.out_dim = PROTECT(Rf_shallow_duplicate(dim));
   INTEGER(info.out_dim)[0] = info.index_n;
 
-  // Initialize `shape_index` to 0
-  SEXP shape_index = PROTECT(Rf_allocVector(INTSXP, info.shape_n));
-  info.p_shape_index = INTEGER(shape_index);
-  for (int i = 0; i < info.shape_n; ++i) {
-    info.p_shape_index[i] = 0;
+  info.col_n = 1;
+  for (int i = 1; i < dim_n; ++i) {
+    info.col_n *= p_dim[i];
+  }
+
+  SEXP out = vec_slice_shaped_base(type, x, index, info);
+
+  UNPROTECT(2);
+  return out;
+}
+
+
+/*
+ * Shaped assignment is the reverse of shaped slicing. `value` has the
+ * same shape as `x` with one row per location of `index`. Column `i`
+ * of `value` starts at `i * index_n` and is assigned to the rows of
+ * column `i` of `x`. Missing locations are skipped.
+ */
+struct vec_assign_shaped_info {
+  const int* p_index;
+  R_len_t index_n;
+  R_len_t col_size;
+  R_xlen_t col_n;
+};
+
+#define ASSIGN_SHAPED_INDEX(CTYPE, DEREF, CONST_DEREF)          \
+  const CTYPE* value_data = CONST_DEREF(value);                 \
+  SEXP out = PROTECT(r_maybe_duplicate(x));                     \
+  CTYPE* out_data = DEREF(out);                                 \
+                                                                \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                   \
+    CTYPE* col_data = out_data + i * info.col_size;             \
+                                                                \
+    for (R_len_t j = 0; j < info.index_n; ++j, ++value_data) {  \
+      int loc = info.p_index[j];                                \
+      if (loc != NA_INTEGER) {                                  \
+        col_data[loc - 1] = *value_data;                        \
+      }                                                         \
+    }                                                           \
+  }                                                             \
+                                                                \
+  UNPROTECT(1);                                                 \
+  return out
+
+#define ASSIGN_SHAPED_COMPACT_SEQ(CTYPE, DEREF, CONST_DEREF)    \
+  R_len_t start = info.p_index[0];                              \
+  R_len_t n = info.p_index[1];                                  \
+  R_len_t step = info.p_index[2];                               \
+                                                                \
+  const CTYPE* value_data = CONST_DEREF(value);                 \
+  SEXP out = PROTECT(r_maybe_duplicate(x));                     \
+  CTYPE* out_data = DEREF(out);                                 \
+                                                                \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                   \
+    CTYPE* col_data = out_data + i * info.col_size + start;     \
+                                                                \
+    if (step == 1) {                                            \
+      memcpy(col_data, value_data, n * sizeof(CTYPE));          \
+      value_data += n;                                          \
+      continue;                                                 \
+    }                                                           \
+                                                                \
+    for (R_len_t j = 0; j < n; ++j, ++value_data, col_data += step) { \
+      *col_data = *value_data;                                  \
+    }                                                           \
+  }                                                             \
+                                                                \
+  UNPROTECT(1);                                                 \
+  return out
+
+#define ASSIGN_SHAPED_COMPACT_RANGES(CTYPE, DEREF, CONST_DEREF) \
+  R_len_t n_ranges = info.p_index[0];                           \
+  const int* p_starts = info.p_index + 2;                       \
+  const int* p_sizes = info.p_index + 2 + n_ranges;             \
+                                                                \
+  const CTYPE* value_data = CONST_DEREF(value);                 \
+  SEXP out = PROTECT(r_maybe_duplicate(x));                     \
+  CTYPE* out_data = DEREF(out);                                 \
+                                                                \
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {                   \
+    CTYPE* col_data = out_data + i * info.col_size;             \
+                                                                \
+    for (R_len_t j = 0; j < n_ranges; ++j) {                    \
+      R_len_t size = p_sizes[j];                                \
+      memcpy(col_data + p_starts[j], value_data, size * sizeof(CTYPE)); \
+      value_data += size;                                       \
+    }                                                           \
+  }                                                             \
+                                                                \
+  UNPROTECT(1);                                                 \
+  return out
+
+#define ASSIGN_SHAPED(CTYPE, DEREF, CONST_DEREF)                \
+  if (is_compact_seq(index)) {                                  \
+    ASSIGN_SHAPED_COMPACT_SEQ(CTYPE, DEREF, CONST_DEREF);       \
+  } else if (is_compact_ranges(index)) {                        \
+    ASSIGN_SHAPED_COMPACT_RANGES(CTYPE, DEREF, CONST_DEREF);    \
+  } else {                                                      \
+    ASSIGN_SHAPED_INDEX(CTYPE, DEREF, CONST_DEREF);             \
+  }
+
+static SEXP lgl_assign_shaped(SEXP x, SEXP index, SEXP value, struct vec_assign_shaped_info info) {
+  ASSIGN_SHAPED(int, LOGICAL, LOGICAL_RO);
+}
+static SEXP int_assign_shaped(SEXP x, SEXP index, SEXP value, struct vec_assign_shaped_info info) {
+  ASSIGN_SHAPED(int, INTEGER, INTEGER_RO);
+}
+static SEXP dbl_assign_shaped(SEXP x, SEXP index, SEXP value, struct vec_assign_shaped_info info) {
+  ASSIGN_SHAPED(double, REAL, REAL_RO);
+}
+static SEXP cpl_assign_shaped(SEXP x, SEXP index, SEXP value, struct vec_assign_shaped_info info) {
+  ASSIGN_SHAPED(Rcomplex, COMPLEX, COMPLEX_RO);
+}
+static SEXP chr_assign_shaped(SEXP x, SEXP index, SEXP value, struct vec_assign_shaped_info info) {
+  ASSIGN_SHAPED(SEXP, STRING_PTR, STRING_PTR_RO);
+}
+static SEXP raw_assign_shaped(SEXP x, SEXP index, SEXP value, struct vec_assign_shaped_info info) {
+  ASSIGN_SHAPED(Rbyte, RAW, RAW_RO);
+}
+
+#undef ASSIGN_SHAPED
+#undef ASSIGN_SHAPED_INDEX
+#undef ASSIGN_SHAPED_COMPACT_SEQ
+#undef ASSIGN_SHAPED_COMPACT_RANGES
+
+static SEXP list_assign_shaped(SEXP x, SEXP index, SEXP value, struct vec_assign_shaped_info info) {
+  SEXP out = PROTECT(r_maybe_duplicate(x));
+  R_xlen_t value_loc = 0;
+
+  for (R_xlen_t i = 0; i < info.col_n; ++i) {
+    R_xlen_t col_loc = i * info.col_size;
+
+    for (R_len_t j = 0; j < info.index_n; ++j, ++value_loc) {
+      int loc = info.p_index[j];
+      if (loc != NA_INTEGER) {
+        SET_VECTOR_ELT(out, col_loc + loc - 1, VECTOR_ELT(value, value_loc));
+      }
+    }
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+/*
+ * `value` must have the type of `proxy` and must have been recycled to
+ * the size of `index`. Lists and compact repetitions are assigned with
+ * materialised locations.
+ *
+ * [[ include("vctrs.h") ]]
+ */
+SEXP vec_assign_shaped(enum vctrs_type type, SEXP proxy, SEXP index, SEXP value) {
+  int nprot = 0;
+
+  if (is_compact_rep(index) || (type == vctrs_type_list && is_compact(index))) {
+    index = PROTECT_N(compact_materialize(index), &nprot);
   }
 
-  info.shape_elem_n = 1;
-  for (int i = 1; i < info.dim_n; ++i) {
-    info.shape_elem_n *= info.p_dim[i];
+  SEXP dim = PROTECT_N(vec_dim(proxy), &nprot);
+  const int* p_dim = INTEGER_RO(dim);
+  R_len_t dim_n = Rf_length(dim);
+
+  struct vec_assign_shaped_info info;
+  info.p_index = INTEGER_RO(index);
+  info.index_n = vec_subscript_size(index);
+  info.col_size = p_dim[0];
+
+  info.col_n = 1;
+  for (int i = 1; i < dim_n; ++i) {
+    info.col_n *= p_dim[i];
   }
 
-  SEXP out = vec_slice_shaped_base(type, x, index, info);
+  if (Rf_xlength(value) != info.col_n * info.index_n) {
+    Rf_error("Internal error in `vec_assign_shaped()`: "
+             "`value` should have been recycled to fit `x`.");
+  }
+
+  SEXP out;
+
+  switch (type) {
+  case vctrs_type_logical:   out = lgl_assign_shaped(proxy, index, value, info); break;
+  case vctrs_type_integer:   out = int_assign_shaped(proxy, index, value, info); break;
+  case vctrs_type_double:    out = dbl_assign_shaped(proxy, index, value, info); break;
+  case vctrs_type_complex:   out = cpl_assign_shaped(proxy, index, value, info); break;
+  case vctrs_type_character: out = chr_assign_shaped(proxy, index, value, info); break;
+  case vctrs_type_raw:       out = raw_assign_shaped(proxy, index, value, info); break;
+  case vctrs_type_list:      out = list_assign_shaped(proxy, index, value, info); break;
+  default: Rf_error("Internal error: Non-vector base type `%s` in `vec_assign_shaped()`",
+                    vec_type_as_str(type));
+  }
 
-  UNPROTECT(4);
+  UNPROTECT(nprot);
   return out;
 }
@@ -19,6 +19,7 @@ SEXP chr_assign(SEXP x, SEXP index, SEXP value);
 static SEXP raw_assign(SEXP x, SEXP index, SEXP value);
 SEXP list_assign(SEXP x, SEXP index, SEXP value);
 SEXP df_assign(SEXP x, SEXP index, SEXP value);
+static SEXP vec_assign_mask(SEXP proxy, SEXP mask, SEXP value);
 
 // [[ register(); include("vctrs.h") ]]
 SEXP vec_assign(SEXP x, SEXP index, SEXP value) {
@@ -36,17 +37,50 @@ SEXP vec_assign(SEXP x, SEXP index, SEXP value) {
   value = PROTECT(vec_coercible_cast(value, x, &value_arg, &x_arg));
   SEXP value_proxy = PROTECT(vec_proxy(value));
 
+  R_len_t size = vec_size(x);
+  struct vctrs_proxy_info info = vec_proxy_info(x);
+  PROTECT(info.proxy);
+  bool fallback = vec_requires_fallback(x, info);
+
+  // Logical masks are streamed through without conversion to locations
+  if (!fallback && is_lgl_mask(index, size)) {
+    R_len_t count = r_lgl_sum(index, true);
+    value_proxy = PROTECT(vec_recycle(value_proxy, count, &value_arg));
+
+    SEXP out = PROTECT(vec_assign_mask(info.proxy, index, value_proxy));
+    out = vec_restore(out, x, R_NilValue);
+
+    UNPROTECT(5);
+    return out;
+  }
+
+  // Consecutive locations are assigned as a block
+  SEXP seq = R_NilValue;
+  if (!fallback) {
+    seq = int_as_compact_location(index, size);
+  }
+  PROTECT(seq);
+
+  if (seq != R_NilValue) {
+    value_proxy = PROTECT(vec_recycle(value_proxy, vec_subscript_size(seq), &value_arg));
+
+    SEXP out = PROTECT(vec_assign_impl(info.proxy, seq, value_proxy));
+    out = vec_restore(out, x, R_NilValue);
+
+    UNPROTECT(6);
+    return out;
+  }
+  UNPROTECT(1);
+
   // Recycle the proxy of `value`
   index = PROTECT(vec_as_location_opts(index,
-                                       vec_size(x),
+                                       size,
                                        PROTECT(vec_names(x)),
                                        vec_as_location_default_assign_opts));
   value_proxy = PROTECT(vec_recycle(value_proxy, vec_size(index), &value_arg));
 
-  struct vctrs_proxy_info info = vec_proxy_info(x);
-
   SEXP out;
-  if (vec_requires_fallback(x, info) || has_dim(x)) {
+  if (fallback) {
     // Restore the value before falling back to `[<-`
     value = PROTECT(vec_restore(value_proxy, value_orig, R_NilValue));
     out = vec_assign_fallback(x, index, value);
@@ -57,7 +91,7 @@ SEXP vec_assign(SEXP x, SEXP index, SEXP value) {
     UNPROTECT(1);
   }
 
-  UNPROTECT(5);
+  UNPROTECT(6);
   return out;
 }
 
@@ -67,7 +101,26 @@ SEXP vec_assign(SEXP x, SEXP index, SEXP value) {
 // way to call `vec_assign_impl()` is to catch and protect its output rather
 // than relying on it to assign directly.
 SEXP vec_assign_impl(SEXP proxy, SEXP index, SEXP value) {
-  switch (vec_proxy_typeof(proxy)) {
+  enum vctrs_type type = vec_proxy_typeof(proxy);
+
+  // Arrays are assigned column by column. `value` has the shape of
+  // `proxy` since it was cast to its type.
+  if (has_dim(proxy)) {
+    switch (type) {
+    case vctrs_type_logical:
+    case vctrs_type_integer:
+    case vctrs_type_double:
+    case vctrs_type_complex:
+    case vctrs_type_character:
+    case vctrs_type_raw:
+    case vctrs_type_list:
+      return vec_assign_shaped(type, proxy, index, value);
+    default:
+      break;
+    }
+  }
+
+  switch (type) {
   case vctrs_type_logical:     return lgl_assign(proxy, index, value);
   case vctrs_type_integer:     return int_assign(proxy, index, value);
   case vctrs_type_double:      return dbl_assign(proxy, index, value);
@@ -131,11 +184,39 @@ SEXP vec_assign_impl(SEXP proxy, SEXP index, SEXP value) {
   UNPROTECT(1);                                                 \
   return out
 
-#define ASSIGN(CTYPE, DEREF, CONST_DEREF)       \
-  if (is_compact_seq(index)) {                  \
-    ASSIGN_COMPACT(CTYPE, DEREF, CONST_DEREF);  \
-  } else {                                      \
-    ASSIGN_INDEX(CTYPE, DEREF, CONST_DEREF);    \
+#define ASSIGN_COMPACT_RANGES(CTYPE, DEREF, CONST_DEREF)        \
+  const int* index_data = INTEGER_RO(index);                    \
+  R_len_t n_ranges = index_data[0];                             \
+  R_len_t n = index_data[1];                                    \
+  const int* p_starts = index_data + 2;                         \
+  const int* p_sizes = index_data + 2 + n_ranges;               \
+                                                                \
+  if (n != Rf_length(value)) {                                  \
+    Rf_error("Internal error in `vec_assign()`: "               \
+             "`value` should have been recycled to fit `x`.");  \
+  }                                                             \
+                                                                \
+  const CTYPE* value_data = CONST_DEREF(value);                 \
+  SEXP out = PROTECT(r_maybe_duplicate(x));                     \
+  CTYPE* out_data = DEREF(out);                                 \
+                                                                \
+  for (R_len_t i = 0; i < n_ranges; ++i) {                      \
+    R_len_t size = p_sizes[i];                                  \
+    CTYPE* range_data = out_data + p_starts[i];                 \
+    memcpy(range_data, value_data, size * sizeof(CTYPE));       \
+    value_data += size;                                         \
+  }                                                             \
+                                                                \
+  UNPROTECT(1);                                                 \
+  return out
+
+#define ASSIGN(CTYPE, DEREF, CONST_DEREF)               \
+  if (is_compact_seq(index)) {                          \
+    ASSIGN_COMPACT(CTYPE, DEREF, CONST_DEREF);          \
+  } else if (is_compact_ranges(index)) {                \
+    ASSIGN_COMPACT_RANGES(CTYPE, DEREF, CONST_DEREF);   \
+  } else {                                              \
+    ASSIGN_INDEX(CTYPE, DEREF, CONST_DEREF);            \
   }
 
 static SEXP lgl_assign(SEXP x, SEXP index, SEXP value) {
@@ -160,6 +241,7 @@ static SEXP raw_assign(SEXP x, SEXP index, SEXP value) {
 #undef ASSIGN
 #undef ASSIGN_INDEX
 #undef ASSIGN_COMPACT
+#undef ASSIGN_COMPACT_RANGES
 
 
 #define ASSIGN_BARRIER_INDEX(GET, SET)                          \
@@ -203,9 +285,38 @@ static SEXP raw_assign(SEXP x, SEXP index, SEXP value) {
   UNPROTECT(1);                                                 \
   return out
 
+#define ASSIGN_BARRIER_COMPACT_RANGES(GET, SET)                 \
+  const int* index_data = INTEGER_RO(index);                    \
+  R_len_t n_ranges = index_data[0];                             \
+  R_len_t n = index_data[1];                                    \
+  const int* p_starts = index_data + 2;                         \
+  const int* p_sizes = index_data + 2 + n_ranges;               \
+                                                                \
+  if (n != Rf_length(value)) {                                  \
+    Rf_error("Internal error in `vec_assign()`: "               \
+             "`value` should have been recycled to fit `x`.");  \
+  }                                                             \
+                                                                \
+  SEXP out = PROTECT(r_maybe_duplicate(x));                     \
+  R_len_t k = 0;                                                \
+                                                                \
+  for (R_len_t i = 0; i < n_ranges; ++i) {                      \
+    R_len_t start = p_starts[i];                                \
+    R_len_t end = start + p_sizes[i];                           \
+                                                                \
+    for (R_len_t j = start; j < end; ++j, ++k) {                \
+      SET(out, j, GET(value, k));                               \
+    }                                                           \
+  }                                                             \
+                                                                \
+  UNPROTECT(1);                                                 \
+  return out
+
 #define ASSIGN_BARRIER(GET, SET)                \
   if (is_compact_seq(index)) {                  \
     ASSIGN_BARRIER_COMPACT(GET, SET);           \
+  } else if (is_compact_ranges(index)) {        \
+    ASSIGN_BARRIER_COMPACT_RANGES(GET, SET);    \
   } else {                                      \
     ASSIGN_BARRIER_INDEX(GET, SET);             \
   }
@@ -217,6 +328,7 @@ SEXP list_assign(SEXP x, SEXP index, SEXP value) {
 #undef ASSIGN_BARRIER
 #undef ASSIGN_BARRIER_INDEX
 #undef ASSIGN_BARRIER_COMPACT
+#undef ASSIGN_BARRIER_COMPACT_RANGES
 
 
 /**
@@ -251,6 +363,141 @@ SEXP df_assign(SEXP x, SEXP index, SEXP value) {
   return out;
 }
 
+
+// Assignment through a logical mask. `value` must have been recycled
+// to the number of `TRUE` and `NA` elements of `mask`. Elements of
+// `value` matching an `NA` are skipped, like missing locations.
+
+#define ASSIGN_MASK(CTYPE, DEREF, CONST_DEREF)                  \
+  R_len_t n = Rf_length(mask);                                  \
+  const int* mask_data = LOGICAL_RO(mask);                      \
+                                                                \
+  const CTYPE* value_data = CONST_DEREF(value);                 \
+  SEXP out = PROTECT(r_maybe_duplicate(x));                     \
+  CTYPE* out_data = DEREF(out);                                 \
+                                                                \
+  for (R_len_t i = 0; i < n; ++i) {                             \
+    int elt = mask_data[i];                                     \
+    if (elt) {                                                  \
+      if (elt != NA_LOGICAL) {                                  \
+        out_data[i] = *value_data;                              \
+      }                                                         \
+      ++value_data;                                             \
+    }                                                           \
+  }                                                             \
+                                                                \
+  UNPROTECT(1);                                                 \
+  return out
+
+static SEXP lgl_assign_mask(SEXP x, SEXP mask, SEXP value) {
+  ASSIGN_MASK(int, LOGICAL, LOGICAL_RO);
+}
+static SEXP int_assign_mask(SEXP x, SEXP mask, SEXP value) {
+  ASSIGN_MASK(int, INTEGER, INTEGER_RO);
+}
+static SEXP dbl_assign_mask(SEXP x, SEXP mask, SEXP value) {
+  ASSIGN_MASK(double, REAL, REAL_RO);
+}
+static SEXP cpl_assign_mask(SEXP x, SEXP mask, SEXP value) {
+  ASSIGN_MASK(Rcomplex, COMPLEX, COMPLEX_RO);
+}
+static SEXP chr_assign_mask(SEXP x, SEXP mask, SEXP value) {
+  ASSIGN_MASK(SEXP, STRING_PTR, STRING_PTR_RO);
+}
+static SEXP raw_assign_mask(SEXP x, SEXP mask, SEXP value) {
+  ASSIGN_MASK(Rbyte, RAW, RAW_RO);
+}
+
+#undef ASSIGN_MASK
+
+static SEXP list_assign_mask(SEXP x, SEXP mask, SEXP value) {
+  R_len_t n = Rf_length(mask);
+  const int* mask_data = LOGICAL_RO(mask);
+
+  SEXP out = PROTECT(r_maybe_duplicate(x));
+  R_len_t j = 0;
+
+  for (R_len_t i = 0; i < n; ++i) {
+    int elt = mask_data[i];
+    if (elt) {
+      if (elt != NA_LOGICAL) {
+        SET_VECTOR_ELT(out, i, VECTOR_ELT(value, j));
+      }
+      ++j;
+    }
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+static SEXP df_assign_mask(SEXP x, SEXP mask, SEXP value) {
+  SEXP out = PROTECT(r_maybe_duplicate(x));
+  R_len_t n = Rf_length(out);
+
+  for (R_len_t i = 0; i < n; ++i) {
+    SEXP out_elt = VECTOR_ELT(out, i);
+    SEXP value_elt = VECTOR_ELT(value, i);
+
+    // Same as `df_assign()`, with the mask shared across columns
+    SEXP proxy_elt = PROTECT(vec_proxy(out_elt));
+    value_elt = PROTECT(vec_proxy(value_elt));
+
+    SEXP assigned = PROTECT(vec_assign_mask(proxy_elt, mask, value_elt));
+    assigned = vec_restore(assigned, out_elt, R_NilValue);
+
+    SET_VECTOR_ELT(out, i, assigned);
+    UNPROTECT(3);
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+static SEXP vec_assign_mask(SEXP proxy, SEXP mask, SEXP value) {
+  // Arrays, including matrix columns of data frames, are assigned by
+  // location column by column
+  if (has_dim(proxy)) {
+    SEXP loc = PROTECT(r_lgl_which(mask, true));
+    SEXP out = vec_assign_impl(proxy, loc, value);
+    UNPROTECT(1);
+    return out;
+  }
+
+  switch (vec_proxy_typeof(proxy)) {
+  case vctrs_type_logical:     return lgl_assign_mask(proxy, mask, value);
+  case vctrs_type_integer:     return int_assign_mask(proxy, mask, value);
+  case vctrs_type_double:      return dbl_assign_mask(proxy, mask, value);
+  case vctrs_type_complex:     return cpl_assign_mask(proxy, mask, value);
+  case vctrs_type_character:   return chr_assign_mask(proxy, mask, value);
+  case vctrs_type_raw:         return raw_assign_mask(proxy, mask, value);
+  case vctrs_type_list:        return list_assign_mask(proxy, mask, value);
+  case vctrs_type_dataframe:   return df_assign_mask(proxy, mask, value);
+  case vctrs_type_null:
+  case vctrs_type_unspecified:
+  case vctrs_type_s3:
+                               Rf_error("Internal error in `vec_assign_mask()`: Unexpected type %s.",
+                                        vec_type_as_str(vec_typeof(proxy)));
+  case vctrs_type_scalar:      stop_scalar_type(proxy, args_empty);
+  }
+  never_reached("vec_assign_mask");
+}
+
+// Exported for testing. `value` must have the type of `x` and the
+// total size of the ranges.
+// [[ register() ]]
+SEXP vctrs_assign_ranges(SEXP x, SEXP starts, SEXP sizes, SEXP value) {
+  SEXP index = PROTECT(compact_ranges(INTEGER_RO(starts), INTEGER_RO(sizes), Rf_length(starts)));
+  SEXP proxy = PROTECT(vec_proxy(x));
+  value = PROTECT(vec_proxy(value));
+
+  SEXP out = PROTECT(vec_assign_impl(proxy, index, value));
+  out = vec_restore(out, x, R_NilValue);
+
+  UNPROTECT(4);
+  return out;
+}
+
 static SEXP vec_assign_fallback(SEXP x, SEXP index, SEXP value) {
   return vctrs_dispatch3(syms_vec_assign_fallback, fns_vec_assign_fallback,
                          syms_x, x,
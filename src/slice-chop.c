@@ -38,7 +38,11 @@ struct vctrs_chop_info {
   *n += 3;                                    \
 } while (0)                                   \
 
-static struct vctrs_chop_info init_chop_info(SEXP x, SEXP indices) {
+/*
+ * @param out An existing container of size `out_size` to chop into, or
+ *   `NULL` to allocate a new one.
+ */
+static struct vctrs_chop_info init_chop_info(SEXP x, SEXP indices, SEXP out) {
   int nprot = 0;
 
   struct vctrs_chop_info info;
@@ -60,7 +64,10 @@ static struct vctrs_chop_info init_chop_info(SEXP x, SEXP indices) {
     info.has_indices = true;
   }
 
-  info.out = PROTECT_N(Rf_allocVector(VECSXP, info.out_size), &nprot);
+  if (out == NULL) {
+    out = Rf_allocVector(VECSXP, info.out_size);
+  }
+  info.out = PROTECT_N(out, &nprot);
 
   UNPROTECT(nprot);
   return info;
@@ -99,8 +106,35 @@ SEXP vctrs_chop_seq(SEXP x, SEXP starts, SEXP sizes, SEXP increasings) {
   return out;
 }
 
+// `starts` and `sizes` are lists of the ranges of each index
+// [[ register() ]]
+SEXP vctrs_chop_ranges(SEXP x, SEXP starts, SEXP sizes) {
+  int n = Rf_length(starts);
+
+  SEXP indices = PROTECT(Rf_allocVector(VECSXP, n));
+
+  for (int i = 0; i < n; ++i) {
+    SEXP elt_starts = VECTOR_ELT(starts, i);
+    SEXP elt_sizes = VECTOR_ELT(sizes, i);
+    SEXP index = compact_ranges(INTEGER_RO(elt_starts), INTEGER_RO(elt_sizes), Rf_length(elt_starts));
+    SET_VECTOR_ELT(indices, i, index);
+  }
+
+  SEXP out = PROTECT(vec_chop(x, indices));
+
+  UNPROTECT(2);
+  return out;
+}
+
+static void check_group_loc_compact(SEXP indices);
+
 // [[ register() ]]
 SEXP vctrs_chop(SEXP x, SEXP indices) {
+  if (OBJECT(indices) && Rf_inherits(indices, "vctrs_group_loc_compact")) {
+    check_group_loc_compact(indices);
+    return vec_chop_compact(x, VECTOR_ELT(indices, 1), VECTOR_ELT(indices, 2));
+  }
+
   R_len_t n = vec_size(x);
   SEXP names = PROTECT(vec_names(x));
 
@@ -116,7 +150,7 @@ SEXP vctrs_chop(SEXP x, SEXP indices) {
 SEXP vec_chop(SEXP x, SEXP indices) {
   int nprot = 0;
 
-  struct vctrs_chop_info info = init_chop_info(x, indices);
+  struct vctrs_chop_info info = init_chop_info(x, indices, NULL);
   PROTECT_CHOP_INFO(&info, &nprot);
 
   SEXP out = PROTECT_N(vec_chop_base(x, indices, info), &nprot);
@@ -125,6 +159,87 @@ SEXP vec_chop(SEXP x, SEXP indices) {
   return out;
 }
 
+/*
+ * Chop `x` with group locations in the compact layout returned by
+ * `vec_group_loc(format = "compact")`. Rather than slicing `x` once
+ * per group with a freshly allocated index, `x` is sliced once with
+ * the permutation `loc`. Each group is then a contiguous range of the
+ * permuted vector, which is chopped with compact sequences. For data
+ * frames, this means each column is gathered once and then copied
+ * block by block.
+ *
+ * [[ include("vctrs.h") ]]
+ */
+SEXP vec_chop_compact(SEXP x, SEXP loc, SEXP offset) {
+  R_len_t n_groups = Rf_length(offset) - 1;
+  const int* p_offset = INTEGER_RO(offset);
+
+  // Stale locations computed for another `x` would permute only part
+  // of it
+  if (vec_size(x) != Rf_length(loc)) {
+    Rf_errorcall(R_NilValue, "`indices$loc` must have the same size as `x`.");
+  }
+
+  SEXP permuted = PROTECT(vec_slice(x, loc));
+
+  // The groups are chopped without bounds checks
+  if (vec_size(permuted) != p_offset[n_groups]) {
+    Rf_error("Internal error in `vec_chop_compact()`: "
+             "`loc` must contain one positive location per element.");
+  }
+
+  SEXP indices = PROTECT(Rf_allocVector(VECSXP, n_groups));
+
+  for (R_len_t i = 0; i < n_groups; ++i) {
+    R_len_t start = p_offset[i];
+    R_len_t size = p_offset[i + 1] - start;
+    SET_VECTOR_ELT(indices, i, compact_seq(start, size, true));
+  }
+
+  SEXP out = vec_chop(permuted, indices);
+
+  UNPROTECT(2);
+  return out;
+}
+
+static void check_group_loc_compact(SEXP indices) {
+  if (TYPEOF(indices) != VECSXP || Rf_length(indices) != 3) {
+    Rf_errorcall(R_NilValue, "`indices` must be a compact group location object.");
+  }
+
+  SEXP loc = VECTOR_ELT(indices, 1);
+  SEXP offset = VECTOR_ELT(indices, 2);
+
+  if (TYPEOF(loc) != INTSXP || TYPEOF(offset) != INTSXP || Rf_length(offset) < 1) {
+    Rf_errorcall(R_NilValue, "`indices` must have integer `loc` and `offset` fields.");
+  }
+
+  R_len_t n_offset = Rf_length(offset);
+  const int* p_offset = INTEGER_RO(offset);
+
+  if (p_offset[0] != 0 || p_offset[n_offset - 1] != Rf_length(loc)) {
+    Rf_errorcall(R_NilValue, "`indices$offset` must start at 0 and end at the size of `indices$loc`.");
+  }
+
+  for (R_len_t i = 1; i < n_offset; ++i) {
+    if (p_offset[i] < p_offset[i - 1]) {
+      Rf_errorcall(R_NilValue, "`indices$offset` must be increasing.");
+    }
+  }
+
+  // Zero and negative locations would shrink the permuted vector.
+  // Locations larger than `n` are reported by `vec_slice()`.
+  R_len_t n_loc = Rf_length(loc);
+  const int* p_loc = INTEGER_RO(loc);
+
+  for (R_len_t i = 0; i < n_loc; ++i) {
+    int elt = p_loc[i];
+    if (elt == NA_INTEGER || elt < 1) {
+      Rf_errorcall(R_NilValue, "`indices$loc` must contain positive locations without missing values.");
+    }
+  }
+}
+
 static SEXP vec_chop_base(SEXP x, SEXP indices, struct vctrs_chop_info info) {
   struct vctrs_proxy_info proxy_info = info.proxy_info;
 
@@ -239,19 +354,30 @@ static SEXP chop_df(SEXP x, SEXP indices, struct vctrs_chop_info info) {
   }
 
   // Split each column according to the indices, and then assign the results
-  // into the appropriate data frame column in the `out` list
+  // into the appropriate data frame column in the `out` list. The
+  // same container is reused to chop every column.
+  SEXP split = PROTECT(Rf_allocVector(VECSXP, info.out_size));
+
   for (int i = 0; i < n_cols; ++i) {
     SEXP col = VECTOR_ELT(info.proxy_info.proxy, i);
-    SEXP split = PROTECT(vec_chop(col, indices));
+
+    struct vctrs_chop_info col_info = init_chop_info(col, indices, split);
+
+    int nprot = 0;
+    PROTECT_CHOP_INFO(&col_info, &nprot);
+
+    vec_chop_base(col, indices, col_info);
 
     for (int j = 0; j < info.out_size; ++j) {
       elt = VECTOR_ELT(info.out, j);
       SET_VECTOR_ELT(elt, i, VECTOR_ELT(split, j));
     }
 
-    UNPROTECT(1);
+    UNPROTECT(nprot);
   }
 
+  UNPROTECT(1);
+
   // Restore each data frame
   for (int i = 0; i < info.out_size; ++i) {
     if (info.has_indices) {
@@ -483,8 +609,6 @@ static SEXP vec_unchop(SEXP x,
 
   indices = PROTECT(vec_as_indices(indices, out_size, R_NilValue));
 
-  const bool is_shaped = has_dim(ptype);
-
   PROTECT_INDEX proxy_pi;
   SEXP proxy = vec_proxy(ptype);
   PROTECT_WITH_INDEX(proxy, &proxy_pi);
@@ -507,13 +631,8 @@ static SEXP vec_unchop(SEXP x,
 
     SEXP index = VECTOR_ELT(indices, i);
 
-    if (is_shaped) {
-      proxy = vec_assign(proxy, index, elt);
-      REPROTECT(proxy, proxy_pi);
-    } else {
-      proxy = vec_assign_impl(proxy, index, elt);
-      REPROTECT(proxy, proxy_pi);
-    }
+    proxy = vec_assign_impl(proxy, index, elt);
+    REPROTECT(proxy, proxy_pi);
 
     if (has_names) {
       R_len_t size = p_sizes[i];
@@ -1,5 +1,7 @@
 #include "vctrs.h"
 #include "altrep.h"
+#include "altrep-rle.h"
+#include "altrep-view.h"
 #include "slice.h"
 #include "subscript-loc.h"
 #include "type-data-frame.h"
@@ -23,6 +25,8 @@ SEXP fns_vec_slice_dispatch_integer64 = NULL;
  *   with base R. When `false`, uses native implementations.
  */
 SEXP vec_slice_impl(SEXP x, SEXP subscript);
+static SEXP vec_slice_opts(SEXP x, SEXP subscript, struct vctrs_proxy_info info, bool trusted);
+static SEXP slice_base(enum vctrs_type type, SEXP x, SEXP subscript, bool subscript_na);
 
 
 #define SLICE_SUBSCRIPT(RTYPE, CTYPE, DEREF, CONST_DEREF, NA_VALUE)     \
@@ -33,6 +37,14 @@ SEXP vec_slice_impl(SEXP x, SEXP subscript);
   SEXP out = PROTECT(Rf_allocVector(RTYPE, n));                         \
   CTYPE* out_data = DEREF(out);                                         \
                                                                         \
+  if (!subscript_na) {                                                  \
+    for (R_len_t i = 0; i < n; ++i) {                                   \
+      out_data[i] = data[subscript_data[i] - 1];                        \
+    }                                                                   \
+    UNPROTECT(1);                                                       \
+    return out;                                                         \
+  }                                                                     \
+                                                                        \
   for (R_len_t i = 0; i < n; ++i, ++subscript_data, ++out_data) {       \
     int j = *subscript_data;                                            \
     *out_data = (j == NA_INTEGER) ? NA_VALUE : data[j - 1];             \
@@ -71,6 +83,12 @@ SEXP vec_slice_impl(SEXP x, SEXP subscript);
   SEXP out = PROTECT(Rf_allocVector(RTYPE, n));                 \
   CTYPE* out_data = DEREF(out);                                 \
                                                                 \
+  if (step == 1) {                                              \
+    memcpy(out_data, data, n * sizeof(CTYPE));                  \
+    UNPROTECT(1);                                               \
+    return out;                                                 \
+  }                                                             \
+                                                                \
   for (int i = 0; i < n; ++i, ++out_data, data += step) {       \
     *out_data = *data;                                          \
   }                                                             \
@@ -78,7 +96,45 @@ SEXP vec_slice_impl(SEXP x, SEXP subscript);
   UNPROTECT(1);                                                 \
   return out
 
+#define SLICE_COMPACT_RANGES(RTYPE, CTYPE, DEREF, CONST_DEREF)  \
+  const int* subscript_data = INTEGER_RO(subscript);            \
+  R_len_t n_ranges = subscript_data[0];                         \
+  R_len_t n = subscript_data[1];                                \
+  const int* p_starts = subscript_data + 2;                     \
+  const int* p_sizes = subscript_data + 2 + n_ranges;           \
+                                                                \
+  const CTYPE* data = CONST_DEREF(x);                           \
+                                                                \
+  SEXP out = PROTECT(Rf_allocVector(RTYPE, n));                 \
+  CTYPE* out_data = DEREF(out);                                 \
+                                                                \
+  for (R_len_t i = 0; i < n_ranges; ++i) {                      \
+    R_len_t size = p_sizes[i];                                  \
+    memcpy(out_data, data + p_starts[i], size * sizeof(CTYPE)); \
+    out_data += size;                                           \
+  }                                                             \
+                                                                \
+  UNPROTECT(1);                                                 \
+  return out
+
+// Contiguous slices reference `x` instead of copying it. Run length
+// encoded vectors are sliced by their runs. Returns `NULL` if `x`
+// can't be viewed.
+static SEXP slice_view(SEXP x, R_len_t start, R_len_t size) {
+  SEXP out = altrep_rle_slice_seq(x, start, size);
+  if (out != NULL) {
+    return out;
+  }
+  return altrep_view_slice(x, start, size);
+}
+
 #define SLICE(RTYPE, CTYPE, DEREF, CONST_DEREF, NA_VALUE)                   \
+  if (is_compact_seq(subscript) && INTEGER(subscript)[2] == 1) {            \
+    SEXP out = slice_view(x, INTEGER(subscript)[0], INTEGER(subscript)[1]); \
+    if (out != NULL) {                                                      \
+      return out;                                                           \
+    }                                                                       \
+  }                                                                         \
   if (ALTREP(x)) {                                                          \
     SEXP alt_subscript = PROTECT(compact_materialize(subscript));           \
     SEXP out = ALTVEC_EXTRACT_SUBSET_PROXY(x, alt_subscript, R_NilValue);   \
@@ -91,32 +147,38 @@ SEXP vec_slice_impl(SEXP x, SEXP subscript);
     SLICE_COMPACT_REP(RTYPE, CTYPE, DEREF, CONST_DEREF, NA_VALUE);          \
   } else if (is_compact_seq(subscript)) {                                   \
     SLICE_COMPACT_SEQ(RTYPE, CTYPE, DEREF, CONST_DEREF);                    \
+  } else if (is_compact_ranges(subscript)) {                                \
+    SLICE_COMPACT_RANGES(RTYPE, CTYPE, DEREF, CONST_DEREF);                 \
   } else {                                                                  \
     SLICE_SUBSCRIPT(RTYPE, CTYPE, DEREF, CONST_DEREF, NA_VALUE);            \
   }
 
-static SEXP lgl_slice(SEXP x, SEXP subscript) {
+// `subscript_na` is `false` when the subscript is known not to
+// contain `NA`. Elements are then gathered without checking for
+// missing locations.
+static SEXP lgl_slice(SEXP x, SEXP subscript, bool subscript_na) {
   SLICE(LGLSXP, int, LOGICAL, LOGICAL_RO, NA_LOGICAL);
 }
-static SEXP int_slice(SEXP x, SEXP subscript) {
+static SEXP int_slice(SEXP x, SEXP subscript, bool subscript_na) {
   SLICE(INTSXP, int, INTEGER, INTEGER_RO, NA_INTEGER);
 }
-static SEXP dbl_slice(SEXP x, SEXP subscript) {
+static SEXP dbl_slice(SEXP x, SEXP subscript, bool subscript_na) {
   SLICE(REALSXP, double, REAL, REAL_RO, NA_REAL);
 }
-static SEXP cpl_slice(SEXP x, SEXP subscript) {
+static SEXP cpl_slice(SEXP x, SEXP subscript, bool subscript_na) {
   SLICE(CPLXSXP, Rcomplex, COMPLEX, COMPLEX_RO, vctrs_shared_na_cpl);
 }
-static SEXP chr_slice(SEXP x, SEXP subscript) {
+static SEXP chr_slice(SEXP x, SEXP subscript, bool subscript_na) {
   SLICE(STRSXP, SEXP, STRING_PTR, STRING_PTR_RO, NA_STRING);
 }
-static SEXP raw_slice(SEXP x, SEXP subscript) {
+static SEXP raw_slice(SEXP x, SEXP subscript, bool subscript_na) {
   SLICE(RAWSXP, Rbyte, RAW, RAW_RO, 0);
 }
 
 #undef SLICE
 #undef SLICE_COMPACT_REP
 #undef SLICE_COMPACT_SEQ
+#undef SLICE_COMPACT_RANGES
 #undef SLICE_SUBSCRIPT
 
 #define SLICE_BARRIER_SUBSCRIPT(RTYPE, GET, SET, NA_VALUE)      \
@@ -166,11 +228,35 @@ static SEXP raw_slice(SEXP x, SEXP subscript) {
   UNPROTECT(1);                                         \
   return out
 
+#define SLICE_BARRIER_COMPACT_RANGES(RTYPE, GET, SET)          \
+  const int* subscript_data = INTEGER_RO(subscript);            \
+  R_len_t n_ranges = subscript_data[0];                         \
+  R_len_t n = subscript_data[1];                                \
+  const int* p_starts = subscript_data + 2;                     \
+  const int* p_sizes = subscript_data + 2 + n_ranges;           \
+                                                                \
+  SEXP out = PROTECT(Rf_allocVector(RTYPE, n));                 \
+  R_len_t k = 0;                                                \
+                                                                \
+  for (R_len_t i = 0; i < n_ranges; ++i) {                      \
+    R_len_t start = p_starts[i];                                \
+    R_len_t end = start + p_sizes[i];                           \
+                                                                \
+    for (R_len_t j = start; j < end; ++j, ++k) {                \
+      SET(out, k, GET(x, j));                                   \
+    }                                                           \
+  }                                                             \
+                                                                \
+  UNPROTECT(1);                                                 \
+  return out
+
 #define SLICE_BARRIER(RTYPE, GET, SET, NA_VALUE)                \
   if (is_compact_rep(subscript)) {                              \
     SLICE_BARRIER_COMPACT_REP(RTYPE, GET, SET, NA_VALUE);       \
   } else if (is_compact_seq(subscript)) {                       \
     SLICE_BARRIER_COMPACT_SEQ(RTYPE, GET, SET);                 \
+  } else if (is_compact_ranges(subscript)) {                    \
+    SLICE_BARRIER_COMPACT_RANGES(RTYPE, GET, SET);              \
   } else {                                                      \
     SLICE_BARRIER_SUBSCRIPT(RTYPE, GET, SET, NA_VALUE);         \
   }
@@ -182,9 +268,30 @@ static SEXP list_slice(SEXP x, SEXP subscript) {
 #undef SLICE_BARRIER
 #undef SLICE_BARRIER_COMPACT_REP
 #undef SLICE_BARRIER_COMPACT_SEQ
+#undef SLICE_BARRIER_COMPACT_RANGES
 #undef SLICE_BARRIER_SUBSCRIPT
 
-static SEXP df_slice(SEXP x, SEXP subscript) {
+// Atomic columns without attributes are gathered directly. They don't
+// need to be proxied, and have no names or attributes to restore.
+static inline bool is_bare_atomic_col(SEXP x) {
+  if (ATTRIB(x) != R_NilValue) {
+    return false;
+  }
+
+  switch (TYPEOF(x)) {
+  case LGLSXP:
+  case INTSXP:
+  case REALSXP:
+  case CPLXSXP:
+  case STRSXP:
+  case RAWSXP:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static SEXP df_slice(SEXP x, SEXP subscript, bool trusted) {
   R_len_t n = Rf_length(x);
   SEXP out = PROTECT(Rf_allocVector(VECSXP, n));
 
@@ -193,9 +300,22 @@ static SEXP df_slice(SEXP x, SEXP subscript) {
   Rf_setAttrib(out, R_NamesSymbol, nms);
   UNPROTECT(1);
 
+  // The subscript is checked for missing locations once for all
+  // columns. Compact subscripts are handled without gathering.
+  bool subscript_na = !trusted && (is_compact(subscript) || r_int_any_na(subscript));
+
   for (R_len_t i = 0; i < n; ++i) {
     SEXP elt = VECTOR_ELT(x, i);
-    SEXP sliced = vec_slice_impl(elt, subscript);
+    SEXP sliced;
+
+    if (is_bare_atomic_col(elt)) {
+      sliced = slice_base(vec_typeof(elt), elt, subscript, subscript_na);
+    } else if (trusted) {
+      sliced = vec_slice_trusted(elt, subscript);
+    } else {
+      sliced = vec_slice_impl(elt, subscript);
+    }
+
     SET_VECTOR_ELT(out, i, sliced);
   }
 
@@ -246,20 +366,24 @@ bool vec_requires_fallback(SEXP x, struct vctrs_proxy_info info) {
     info.type != vctrs_type_dataframe;
 }
 
-SEXP vec_slice_base(enum vctrs_type type, SEXP x, SEXP subscript) {
+static SEXP slice_base(enum vctrs_type type, SEXP x, SEXP subscript, bool subscript_na) {
   switch (type) {
-  case vctrs_type_logical:   return lgl_slice(x, subscript);
-  case vctrs_type_integer:   return int_slice(x, subscript);
-  case vctrs_type_double:    return dbl_slice(x, subscript);
-  case vctrs_type_complex:   return cpl_slice(x, subscript);
-  case vctrs_type_character: return chr_slice(x, subscript);
-  case vctrs_type_raw:       return raw_slice(x, subscript);
+  case vctrs_type_logical:   return lgl_slice(x, subscript, subscript_na);
+  case vctrs_type_integer:   return int_slice(x, subscript, subscript_na);
+  case vctrs_type_double:    return dbl_slice(x, subscript, subscript_na);
+  case vctrs_type_complex:   return cpl_slice(x, subscript, subscript_na);
+  case vctrs_type_character: return chr_slice(x, subscript, subscript_na);
+  case vctrs_type_raw:       return raw_slice(x, subscript, subscript_na);
   case vctrs_type_list:      return list_slice(x, subscript);
   default: Rf_error("Internal error: Non-vector base type `%s` in `vec_slice_base()`",
                     vec_type_as_str(type));
   }
 }
 
+SEXP vec_slice_base(enum vctrs_type type, SEXP x, SEXP subscript) {
+  return slice_base(type, x, subscript, true);
+}
+
 // Replace any `NA` name caused by `NA` subscript with the empty
 // string. It's ok mutate the names vector since it is freshly
 // created, but we make an additional check for that anyways
@@ -269,8 +393,8 @@ static void repair_na_names(SEXP names, SEXP subscript) {
     Rf_errorcall(R_NilValue, "Internal error: `names` must not be referenced.");
   }
 
-  // No possible way to have `NA_integer_` in a compact seq
-  if (is_compact_seq(subscript)) {
+  // No possible way to have `NA_integer_` in a compact seq or ranges
+  if (is_compact_seq(subscript) || is_compact_ranges(subscript)) {
     return;
   }
 
@@ -303,24 +427,29 @@ static void repair_na_names(SEXP names, SEXP subscript) {
   }
 }
 
-SEXP slice_names(SEXP names, SEXP subscript) {
+static SEXP slice_names_opts(SEXP names, SEXP subscript, bool subscript_na) {
   if (names == R_NilValue) {
     return names;
   }
 
-  names = PROTECT(chr_slice(names, subscript));
+  names = PROTECT(chr_slice(names, subscript, subscript_na));
 
-  repair_na_names(names, subscript);
+  if (subscript_na) {
+    repair_na_names(names, subscript);
+  }
 
   UNPROTECT(1);
   return names;
 }
+SEXP slice_names(SEXP names, SEXP subscript) {
+  return slice_names_opts(names, subscript, true);
+}
 SEXP slice_rownames(SEXP names, SEXP subscript) {
   if (names == R_NilValue) {
     return names;
   }
 
-  names = PROTECT(chr_slice(names, subscript));
+  names = PROTECT(chr_slice(names, subscript, true));
 
   // Rownames can't contain `NA` or duplicates
   names = vec_as_unique_names(names, true);
@@ -332,11 +461,40 @@ SEXP slice_rownames(SEXP names, SEXP subscript) {
 SEXP vec_slice_impl(SEXP x, SEXP subscript) {
   int nprot = 0;
 
-  SEXP restore_size = PROTECT_N(r_int(vec_subscript_size(subscript)), &nprot);
+  struct vctrs_proxy_info info = vec_proxy_info(x);
+  PROTECT_PROXY_INFO(&info, &nprot);
+
+  SEXP out = vec_slice_opts(x, subscript, info, false);
+
+  UNPROTECT(nprot);
+  return out;
+}
+
+/*
+ * Slice with a subscript generated by vctrs itself. The subscript must
+ * be a compact subscript or an integer vector of 1-based, in-bounds
+ * locations without missing values. It is not validated, and names
+ * and columns are gathered without checking for missing locations.
+ *
+ * [[ include("vctrs.h") ]]
+ */
+SEXP vec_slice_trusted(SEXP x, SEXP subscript) {
+  int nprot = 0;
 
   struct vctrs_proxy_info info = vec_proxy_info(x);
   PROTECT_PROXY_INFO(&info, &nprot);
 
+  SEXP out = vec_slice_opts(x, subscript, info, true);
+
+  UNPROTECT(nprot);
+  return out;
+}
+
+static SEXP vec_slice_opts(SEXP x, SEXP subscript, struct vctrs_proxy_info info, bool trusted) {
+  int nprot = 0;
+
+  SEXP restore_size = PROTECT_N(r_int(vec_subscript_size(subscript)), &nprot);
+
   SEXP data = info.proxy;
 
   // Fallback to `[` if the class doesn't implement a proxy. This is
@@ -388,15 +546,15 @@ SEXP vec_slice_impl(SEXP x, SEXP subscript) {
       if (names != R_NilValue) {
         names = PROTECT_N(Rf_shallow_duplicate(names), &nprot);
         SEXP row_names = VECTOR_ELT(names, 0);
-        row_names = PROTECT_N(slice_names(row_names, subscript), &nprot);
+        row_names = PROTECT_N(slice_names_opts(row_names, subscript, !trusted), &nprot);
         SET_VECTOR_ELT(names, 0, row_names);
         Rf_setAttrib(out, R_DimNamesSymbol, names);
       }
     } else {
-      out = PROTECT_N(vec_slice_base(info.type, data, subscript), &nprot);
+      out = PROTECT_N(slice_base(info.type, data, subscript, !trusted), &nprot);
 
       SEXP names = PROTECT_N(Rf_getAttrib(x, R_NamesSymbol), &nprot);
-      names = PROTECT_N(slice_names(names, subscript), &nprot);
+      names = PROTECT_N(slice_names_opts(names, subscript, !trusted), &nprot);
       Rf_setAttrib(out, R_NamesSymbol, names);
     }
 
@@ -407,7 +565,7 @@ SEXP vec_slice_impl(SEXP x, SEXP subscript) {
   }
 
   case vctrs_type_dataframe: {
-    SEXP out = PROTECT_N(df_slice(data, subscript), &nprot);
+    SEXP out = PROTECT_N(df_slice(data, subscript, trusted), &nprot);
     out = vec_restore(out, x, restore_size);
     UNPROTECT(nprot);
     return out;
@@ -419,11 +577,151 @@ SEXP vec_slice_impl(SEXP x, SEXP subscript) {
   }
 }
 
+#define SLICE_MASK(RTYPE, CTYPE, DEREF, CONST_DEREF, NA_VALUE)  \
+  const CTYPE* data = CONST_DEREF(x);                           \
+  const int* mask_data = LOGICAL_RO(mask);                      \
+  R_len_t n = Rf_length(mask);                                  \
+                                                                \
+  SEXP out = PROTECT(Rf_allocVector(RTYPE, count));             \
+  CTYPE* out_data = DEREF(out);                                 \
+                                                                \
+  for (R_len_t i = 0; i < n; ++i) {                             \
+    int elt = mask_data[i];                                     \
+    if (elt) {                                                  \
+      *out_data++ = (elt == NA_LOGICAL) ? NA_VALUE : data[i];   \
+    }                                                           \
+  }                                                             \
+                                                                \
+  UNPROTECT(1);                                                 \
+  return out
+
+static SEXP lgl_slice_mask(SEXP x, SEXP mask, R_len_t count) {
+  SLICE_MASK(LGLSXP, int, LOGICAL, LOGICAL_RO, NA_LOGICAL);
+}
+static SEXP int_slice_mask(SEXP x, SEXP mask, R_len_t count) {
+  SLICE_MASK(INTSXP, int, INTEGER, INTEGER_RO, NA_INTEGER);
+}
+static SEXP dbl_slice_mask(SEXP x, SEXP mask, R_len_t count) {
+  SLICE_MASK(REALSXP, double, REAL, REAL_RO, NA_REAL);
+}
+static SEXP cpl_slice_mask(SEXP x, SEXP mask, R_len_t count) {
+  SLICE_MASK(CPLXSXP, Rcomplex, COMPLEX, COMPLEX_RO, vctrs_shared_na_cpl);
+}
+static SEXP chr_slice_mask(SEXP x, SEXP mask, R_len_t count) {
+  SLICE_MASK(STRSXP, SEXP, STRING_PTR, STRING_PTR_RO, NA_STRING);
+}
+static SEXP raw_slice_mask(SEXP x, SEXP mask, R_len_t count) {
+  SLICE_MASK(RAWSXP, Rbyte, RAW, RAW_RO, 0);
+}
+
+#undef SLICE_MASK
+
+static SEXP slice_mask_base(enum vctrs_type type, SEXP x, SEXP mask, R_len_t count) {
+  switch (type) {
+  case vctrs_type_logical:   return lgl_slice_mask(x, mask, count);
+  case vctrs_type_integer:   return int_slice_mask(x, mask, count);
+  case vctrs_type_double:    return dbl_slice_mask(x, mask, count);
+  case vctrs_type_complex:   return cpl_slice_mask(x, mask, count);
+  case vctrs_type_character: return chr_slice_mask(x, mask, count);
+  case vctrs_type_raw:       return raw_slice_mask(x, mask, count);
+  default: Rf_error("Internal error: Non-atomic type `%s` in `slice_mask_base()`",
+                    vec_type_as_str(type));
+  }
+}
+
+// ALTREP vectors are sliced through their own methods rather than
+// materialised by the mask
+static inline bool is_mask_atomic(SEXP x) {
+  return is_bare_atomic_col(x) && !ALTREP(x);
+}
+
+/*
+ * Bare data frame columns are compressed directly from the mask. The
+ * number of selected rows is counted once for all columns. Other
+ * columns, and the row names, are sliced with locations that are only
+ * computed when needed.
+ */
+static SEXP df_slice_mask(SEXP x, SEXP mask, R_len_t count) {
+  int nprot = 0;
+
+  R_len_t n = Rf_length(x);
+  SEXP out = PROTECT_N(Rf_allocVector(VECSXP, n), &nprot);
+
+  SEXP nms = PROTECT(Rf_getAttrib(x, R_NamesSymbol));
+  Rf_setAttrib(out, R_NamesSymbol, nms);
+  UNPROTECT(1);
+
+  SEXP loc = R_NilValue;
+
+  for (R_len_t i = 0; i < n; ++i) {
+    SEXP elt = VECTOR_ELT(x, i);
+    SEXP sliced;
+
+    if (is_mask_atomic(elt)) {
+      sliced = slice_mask_base(vec_typeof(elt), elt, mask, count);
+    } else {
+      if (loc == R_NilValue) {
+        loc = PROTECT_N(r_lgl_which(mask, true), &nprot);
+      }
+      sliced = vec_slice_impl(elt, loc);
+    }
+
+    SET_VECTOR_ELT(out, i, sliced);
+  }
+
+  SEXP row_nms = PROTECT_N(df_rownames(x), &nprot);
+  if (TYPEOF(row_nms) == STRSXP) {
+    if (loc == R_NilValue) {
+      loc = PROTECT_N(r_lgl_which(mask, true), &nprot);
+    }
+    row_nms = PROTECT_N(slice_rownames(row_nms, loc), &nprot);
+    Rf_setAttrib(out, R_RowNamesSymbol, row_nms);
+  }
+
+  UNPROTECT(nprot);
+  return out;
+}
+
+// Returns `NULL` when `x` must be sliced by location
+static SEXP vec_slice_mask(SEXP x, SEXP mask) {
+  if (is_mask_atomic(x)) {
+    return slice_mask_base(vec_typeof(x), x, mask, r_lgl_sum(mask, true));
+  }
+
+  if (is_bare_data_frame(x)) {
+    R_len_t count = r_lgl_sum(mask, true);
+    SEXP out = PROTECT(df_slice_mask(x, mask, count));
+    out = vec_restore(out, x, PROTECT(r_int(count)));
+    UNPROTECT(2);
+    return out;
+  }
+
+  return NULL;
+}
+
 // [[export]]
 SEXP vctrs_slice(SEXP x, SEXP subscript) {
   vec_assert(x, args_empty);
 
-  subscript = PROTECT(vec_as_location(subscript, vec_size(x), PROTECT(vec_names(x))));
+  R_len_t size = vec_size(x);
+
+  if (is_lgl_mask(subscript, size)) {
+    SEXP out = vec_slice_mask(x, subscript);
+    if (out != NULL) {
+      return out;
+    }
+  }
+
+  // Consecutive locations are sliced as a block
+  SEXP seq = PROTECT(int_as_compact_location(subscript, size));
+  if (seq != R_NilValue) {
+    SEXP out = vec_slice_impl(x, seq);
+    UNPROTECT(1);
+    return out;
+  }
+  UNPROTECT(1);
+
+  subscript = PROTECT(vec_as_location(subscript, size, PROTECT(vec_names(x))));
   SEXP out = vec_slice_impl(x, subscript);
 
   UNPROTECT(2);
@@ -480,6 +778,16 @@ SEXP vec_slice_rep(SEXP x, SEXP i, SEXP n) {
   return out;
 }
 
+// Exported for testing
+// [[ register() ]]
+SEXP vec_slice_ranges(SEXP x, SEXP starts, SEXP sizes) {
+  SEXP subscript = PROTECT(compact_ranges(INTEGER_RO(starts), INTEGER_RO(sizes), Rf_length(starts)));
+  SEXP out = vec_slice_impl(x, subscript);
+
+  UNPROTECT(1);
+  return out;
+}
+
 
 void vctrs_init_slice(SEXP ns) {
   syms_vec_slice_fallback = Rf_install("vec_slice_fallback");
@@ -1,24 +1,59 @@
 #include "vctrs.h"
+#include "type-data-frame.h"
 #include "utils.h"
 
-// [[ register() ]]
+static SEXP split_groups(SEXP x, SEXP groups);
+
+// [[ include("vctrs.h") ]]
 SEXP vec_split(SEXP x, SEXP by) {
   if (vec_size(x) != vec_size(by)) {
     Rf_errorcall(R_NilValue, "`x` and `by` must have the same size.");
   }
 
-  SEXP out = PROTECT(vec_group_loc(by));
+  // The compact layout avoids allocating a location vector per group
+  SEXP groups = PROTECT(vec_group_loc_compact(by));
+  SEXP out = split_groups(x, groups);
+
+  UNPROTECT(1);
+  return out;
+}
+
+// [[ register() ]]
+SEXP vctrs_split(SEXP x, SEXP by, SEXP by_proxy) {
+  if (by_proxy == R_NilValue) {
+    return vec_split(x, by);
+  }
+
+  if (vec_size(x) != vec_size(by)) {
+    Rf_errorcall(R_NilValue, "`x` and `by` must have the same size.");
+  }
+
+  SEXP groups = PROTECT(vec_group_loc_sorted(by, by_proxy, true));
+  SEXP out = split_groups(x, groups);
+
+  UNPROTECT(1);
+  return out;
+}
+
+static SEXP split_groups(SEXP x, SEXP groups) {
+
+  SEXP key = VECTOR_ELT(groups, 0);
+  SEXP loc = VECTOR_ELT(groups, 1);
+  SEXP offset = VECTOR_ELT(groups, 2);
 
-  SEXP indices = VECTOR_ELT(out, 1);
+  SEXP val = PROTECT(vec_chop_compact(x, loc, offset));
 
-  SEXP val = vec_chop(x, indices);
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(out, 0, key);
   SET_VECTOR_ELT(out, 1, val);
 
-  SEXP names = PROTECT(Rf_getAttrib(out, R_NamesSymbol));
+  SEXP names = PROTECT(Rf_allocVector(STRSXP, 2));
+  SET_STRING_ELT(names, 0, strings_key);
   SET_STRING_ELT(names, 1, strings_val);
   Rf_setAttrib(out, R_NamesSymbol, names);
 
-  UNPROTECT(2);
+  out = new_data_frame(out, Rf_length(offset) - 1);
+
+  UNPROTECT(3);
   return out;
 }
-
@@ -1,7 +1,11 @@
 #include "vctrs.h"
+#include "altrep.h"
 #include "utils.h"
 #include "subscript-loc.h"
 
+// Initialised at load time
+static SEXP syms_compact_intseq = NULL;
+
 static SEXP int_invert_location(SEXP subscript, R_len_t n,
                                 const struct vec_as_location_opts* opts);
 static SEXP int_filter_zero(SEXP subscript, R_len_t n_zero);
@@ -275,6 +279,179 @@ static SEXP chr_as_location(SEXP subscript, SEXP names,
   return matched;
 }
 
+#if (R_VERSION >= R_Version(3, 5, 0))
+// R's compact integer sequences, e.g. `1:n` or `seq(a, b)`, store their
+// size, first element and increment in a double vector. They are read
+// without expanding the sequence. Once expanded, the sequence might
+// have been modified in place so it is not trusted.
+//
+// This relies on the private layout of R's `compact_intseq` class, as
+// of R 3.5 to 4.0. It is checked by the tests of `vctrs_intseq_info()`
+// so that a change in R fails loudly rather than disabling this path.
+static bool r_intseq_info(SEXP x, R_len_t* p_first, int* p_step) {
+  if (!ALTREP(x)) {
+    return false;
+  }
+
+  SEXP cls_attrib = ATTRIB(ALTREP_CLASS(x));
+  if (TYPEOF(cls_attrib) != LISTSXP || CAR(cls_attrib) != syms_compact_intseq) {
+    return false;
+  }
+  if (R_altrep_data2(x) != R_NilValue) {
+    return false;
+  }
+
+  SEXP info = R_altrep_data1(x);
+  if (TYPEOF(info) != REALSXP || Rf_length(info) != 3) {
+    return false;
+  }
+
+  *p_first = (R_len_t) REAL(info)[1];
+  *p_step = (int) REAL(info)[2];
+  return true;
+}
+#else
+static bool r_intseq_info(SEXP x, R_len_t* p_first, int* p_step) {
+  return false;
+}
+#endif
+
+// Exported for testing
+// [[ register() ]]
+SEXP vctrs_intseq_info(SEXP x) {
+  R_len_t first;
+  int step;
+
+  if (!r_intseq_info(x, &first, &step)) {
+    return R_NilValue;
+  }
+
+  SEXP out = PROTECT(Rf_allocVector(INTSXP, 2));
+  INTEGER(out)[0] = first;
+  INTEGER(out)[1] = step;
+
+  UNPROTECT(1);
+  return out;
+}
+
+static SEXP int_as_compact_ranges(SEXP subscript, R_len_t n);
+
+/*
+ * Returns a compact sequence if `subscript` is a bare integer vector of
+ * consecutive locations in `[1, n]`, in increasing or decreasing
+ * order. Increasing subscripts made of a few blocks of consecutive
+ * locations are returned as compact ranges. Returns `NULL` otherwise,
+ * in which case `subscript` should go through `vec_as_location()`.
+ * Compact integer sequences created by R are recognised without being
+ * materialised.
+ *
+ * [[ include("subscript-loc.h") ]]
+ */
+SEXP int_as_compact_location(SEXP subscript, R_len_t n) {
+  if (TYPEOF(subscript) != INTSXP || ATTRIB(subscript) != R_NilValue) {
+    return R_NilValue;
+  }
+
+  R_len_t size = Rf_length(subscript);
+  if (size < 2) {
+    return R_NilValue;
+  }
+
+  R_len_t first;
+  int step;
+  bool intseq = r_intseq_info(subscript, &first, &step);
+
+  const int* p_subscript = NULL;
+
+  if (!intseq) {
+    p_subscript = INTEGER_RO(subscript);
+    first = p_subscript[0];
+
+    if (first == NA_INTEGER || p_subscript[1] == NA_INTEGER) {
+      return R_NilValue;
+    }
+
+    // The difference of two locations can overflow an `int`
+    int64_t diff = (int64_t) p_subscript[1] - first;
+    step = (diff == 1 || diff == -1) ? (int) diff : 0;
+  }
+
+  if (step != 1 && step != -1) {
+    return int_as_compact_ranges(subscript, n);
+  }
+
+  // Checking the bounds of the last location first ensures that the
+  // locations can't overflow below
+  double last = (double) first + (double) (size - 1) * step;
+  if (first < 1 || first > n || last < 1 || last > n) {
+    return (step == 1 && !intseq) ? int_as_compact_ranges(subscript, n) : R_NilValue;
+  }
+
+  if (!intseq) {
+    for (R_len_t i = 2; i < size; ++i) {
+      if (p_subscript[i] != p_subscript[i - 1] + step) {
+        return (step == 1) ? int_as_compact_ranges(subscript, n) : R_NilValue;
+      }
+    }
+  }
+
+  return compact_seq(first - 1, size, step == 1);
+}
+
+// Blocks must have 4 locations on average to be worth copying as
+// ranges. The scan stops early if new blocks start too often, so that
+// unsorted subscripts are rejected quickly.
+#define COMPACT_RANGES_MIN_SIZE 4
+#define COMPACT_RANGES_SLACK 16
+
+static SEXP int_as_compact_ranges(SEXP subscript, R_len_t n) {
+  const int* p_subscript = INTEGER_RO(subscript);
+  R_len_t size = Rf_length(subscript);
+
+  R_len_t n_ranges = 0;
+
+  for (R_len_t i = 0; i < size; ++i) {
+    int elt = p_subscript[i];
+
+    if (elt == NA_INTEGER || elt < 1 || elt > n) {
+      return R_NilValue;
+    }
+
+    if (i == 0 || elt - 1 != p_subscript[i - 1]) {
+      ++n_ranges;
+      if (n_ranges > i / COMPACT_RANGES_MIN_SIZE + COMPACT_RANGES_SLACK) {
+        return R_NilValue;
+      }
+    }
+  }
+
+  if (n_ranges > size / COMPACT_RANGES_MIN_SIZE) {
+    return R_NilValue;
+  }
+
+  int* p_starts = (int*) R_alloc(n_ranges, sizeof(int));
+  int* p_sizes = (int*) R_alloc(n_ranges, sizeof(int));
+
+  R_len_t k = -1;
+
+  for (R_len_t i = 0; i < size; ++i) {
+    int elt = p_subscript[i];
+
+    if (i == 0 || elt - 1 != p_subscript[i - 1]) {
+      ++k;
+      p_starts[k] = elt - 1;
+      p_sizes[k] = 0;
+    }
+
+    ++p_sizes[k];
+  }
+
+  return compact_ranges(p_starts, p_sizes, n_ranges);
+}
+
+#undef COMPACT_RANGES_MIN_SIZE
+#undef COMPACT_RANGES_SLACK
+
 SEXP vec_as_location(SEXP subscript, R_len_t n, SEXP names) {
   return vec_as_location_opts(subscript,
                               n,
@@ -504,6 +681,8 @@ struct vec_as_location_opts vec_as_location_default_opts_obj;
 struct vec_as_location_opts vec_as_location_default_assign_opts_obj;
 
 void vctrs_init_subscript_loc(SEXP ns) {
+  syms_compact_intseq = Rf_install("compact_intseq");
+
   vec_as_location_default_opts_obj.action = SUBSCRIPT_ACTION_DEFAULT;
   vec_as_location_default_opts_obj.loc_negative = LOC_NEGATIVE_INVERT;
   vec_as_location_default_opts_obj.loc_oob = LOC_OOB_ERROR;
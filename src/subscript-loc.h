@@ -52,6 +52,18 @@ SEXP vec_as_location(SEXP i, R_len_t n, SEXP names);
 SEXP vec_as_location_opts(SEXP i, R_len_t n, SEXP names,
                           const struct vec_as_location_opts* opts);
 
+SEXP int_as_compact_location(SEXP subscript, R_len_t n);
+
+// A bare logical subscript of size `n` selects the same elements as
+// the locations of its `TRUE` and `NA` values. Slicing and assignment
+// can then stream through it without converting it to locations.
+static inline bool is_lgl_mask(SEXP subscript, R_len_t n) {
+  return
+    TYPEOF(subscript) == LGLSXP &&
+    ATTRIB(subscript) == R_NilValue &&
+    Rf_length(subscript) == n;
+}
+
 static inline SEXP get_opts_action(const struct vec_as_location_opts* opts) {
   switch (opts->action) {
   case SUBSCRIPT_ACTION_DEFAULT: return R_NilValue;
@@ -1,6 +1,64 @@
 #include "vctrs.h"
 #include "utils.h"
 
+// -----------------------------------------------------------------------------
+// Session-wide cache of UTF-8 translations of CHARSXPs
+
+// Comparing or hashing strings with mixed encodings requires a UTF-8
+// translation of each string. Sorting a column would translate the
+// same strings O(n log n) times, so translations are memoised in a
+// direct-mapped cache keyed on the CHARSXP pointer. The keys and the
+// translated values are stored in preserved character vectors. This
+// keeps cached CHARSXPs alive so their addresses can't be recycled
+// by the GC while they are in the cache, and bounds the number of
+// strings we keep alive to `TRANSLATE_CACHE_SIZE`.
+
+#define TRANSLATE_CACHE_SIZE 4096
+
+// Initialised at load time
+static SEXP translate_cache_keys = NULL;
+static SEXP translate_cache_values = NULL;
+
+static inline R_len_t translate_cache_slot(SEXP x) {
+  // CHARSXP addresses are at least 8-byte aligned, discard the low bits
+  uint64_t key = ((uintptr_t) x) >> 3;
+  key *= UINT64_C(0x9e3779b97f4a7c15);
+  return (R_len_t) (key >> 52);
+}
+
+/**
+ * Translate a CHARSXP to UTF-8
+ *
+ * Returns `x` itself if it is `NA` or is already marked as UTF-8.
+ * Otherwise returns the UTF-8 CHARSXP corresponding to `x`. Like
+ * `Rf_translateCharUTF8()`, this fails on strings marked as bytes.
+ *
+ * The result is only kept alive while it stays in the cache. Protect
+ * it if you allocate before you're done with it.
+ *
+ * [[ include("vctrs.h") ]]
+ */
+SEXP str_translate_utf8(SEXP x) {
+  if (x == NA_STRING || Rf_getCharCE(x) == CE_UTF8) {
+    return x;
+  }
+
+  R_len_t slot = translate_cache_slot(x);
+
+  if (STRING_ELT(translate_cache_keys, slot) == x) {
+    return STRING_ELT(translate_cache_values, slot);
+  }
+
+  const void* vmax = vmaxget();
+  SEXP out = Rf_mkCharCE(Rf_translateCharUTF8(x), CE_UTF8);
+  vmaxset(vmax);
+
+  SET_STRING_ELT(translate_cache_values, slot, out);
+  SET_STRING_ELT(translate_cache_keys, slot, x);
+
+  return out;
+}
+
 // -----------------------------------------------------------------------------
 // Helpers for determining if UTF-8 translation is required for character
 // vectors
@@ -212,22 +270,17 @@ static SEXP chr_translate_encoding(SEXP x, R_len_t size) {
   const SEXP* p_x = STRING_PTR_RO(x);
 
   SEXP out = PROTECT(r_maybe_duplicate(x));
-  SEXP* p_out = STRING_PTR(out);
-
-  const void *vmax = vmaxget();
 
   for (int i = 0; i < size; ++i) {
     SEXP chr = p_x[i];
 
     if (Rf_getCharCE(chr) == CE_UTF8) {
-      p_out[i] = chr;
       continue;
     }
 
-    p_out[i] = Rf_mkCharCE(Rf_translateCharUTF8(chr), CE_UTF8);
+    SET_STRING_ELT(out, i, str_translate_utf8(chr));
   }
 
-  vmaxset(vmax);
   UNPROTECT(1);
   return out;
 }
@@ -314,6 +367,96 @@ static SEXP df_maybe_translate_encoding(SEXP x, R_len_t size) {
   return x;
 }
 
+// -----------------------------------------------------------------------------
+// Utilities for translating strings to UTF-8 before ordering them by
+// their bytes.
+
+// Unlike `obj_maybe_translate_encoding()`, which only translates
+// vectors with mixed encodings, this translates every string whose
+// bytes are not already UTF-8: latin1 strings, and native strings with
+// non-ASCII characters. Strings marked as bytes are left as is.
+
+// Notes:
+// - Assumes that `x` has been translated with
+//   `obj_maybe_translate_encoding()`, which reports mixtures of bytes
+//   and other encodings.
+
+static bool str_requires_utf8_translation(SEXP x) {
+  switch (Rf_getCharCE(x)) {
+  case CE_LATIN1: return true;
+  case CE_NATIVE: break;
+  default: return false;
+  }
+
+  if (x == NA_STRING) {
+    return false;
+  }
+
+  for (const unsigned char* p_x = (const unsigned char*) CHAR(x); *p_x; ++p_x) {
+    if (*p_x > 127) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static SEXP chr_translate_utf8(SEXP x, R_len_t size) {
+  const SEXP* p_x = STRING_PTR_RO(x);
+
+  R_len_t i = 0;
+  for (; i < size; ++i) {
+    if (str_requires_utf8_translation(p_x[i])) {
+      break;
+    }
+  }
+
+  if (i == size) {
+    return x;
+  }
+
+  SEXP out = PROTECT(r_maybe_duplicate(x));
+
+  for (; i < size; ++i) {
+    SEXP chr = p_x[i];
+    if (str_requires_utf8_translation(chr)) {
+      SET_STRING_ELT(out, i, str_translate_utf8(chr));
+    }
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
+// [[ include("vctrs.h") ]]
+SEXP obj_translate_utf8(SEXP x, R_len_t size) {
+  switch (TYPEOF(x)) {
+  case STRSXP: {
+    // Arrays are ordered by all of their columns
+    return chr_translate_utf8(x, Rf_length(x));
+  }
+  case VECSXP: {
+    if (!is_data_frame(x)) {
+      return x;
+    }
+
+    int n_col = Rf_length(x);
+    x = PROTECT(r_maybe_duplicate(x));
+
+    for (int i = 0; i < n_col; ++i) {
+      SEXP col = VECTOR_ELT(x, i);
+      SET_VECTOR_ELT(x, i, obj_translate_utf8(col, size));
+    }
+
+    UNPROTECT(1);
+    return x;
+  }
+  default: {
+    return x;
+  }
+  }
+}
+
 // -----------------------------------------------------------------------------
 // Utilities for translating encodings of `x` and `y` relative to each other,
 // if required.
@@ -443,3 +586,13 @@ SEXP vctrs_maybe_translate_encoding2(SEXP x, SEXP y) {
   return out;
 }
 
+
+void vctrs_init_translate(SEXP ns) {
+  VCTRS_ASSERT(TRANSLATE_CACHE_SIZE == (1 << 12));
+
+  translate_cache_keys = Rf_allocVector(STRSXP, TRANSLATE_CACHE_SIZE);
+  R_PreserveObject(translate_cache_keys);
+
+  translate_cache_values = Rf_allocVector(STRSXP, TRANSLATE_CACHE_SIZE);
+  R_PreserveObject(translate_cache_values);
+}
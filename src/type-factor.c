@@ -206,10 +206,12 @@ static SEXP remove_na_levels(SEXP levels) {
   // Remove it if it exists.
   for (R_len_t i = 0; i < size; ++i) {
     if (p_levels[i] == NA_STRING) {
-      int na_loc = (i + 1) * -1;
+      // Keep the levels on both sides of the `NA` level
+      int starts[2] = { 0, i + 1 };
+      int sizes[2] = { i, size - i - 1 };
 
-      SEXP na_loc_obj = PROTECT(r_int(na_loc));
-      SEXP out = vec_slice(levels, na_loc_obj);
+      SEXP loc = PROTECT(compact_ranges(starts, sizes, 2));
+      SEXP out = vec_slice_trusted(levels, loc);
 
       UNPROTECT(1);
       return out;
@@ -33,6 +33,7 @@ SEXP classes_posixct = NULL;
 SEXP classes_tibble = NULL;
 SEXP classes_list_of = NULL;
 SEXP classes_vctrs_group_rle = NULL;
+SEXP classes_vctrs_group_loc_compact = NULL;
 
 static SEXP syms_as_data_frame2 = NULL;
 static SEXP fns_as_data_frame2 = NULL;
@@ -111,6 +112,46 @@ SEXP vctrs_eval_mask5(SEXP fn,
   return vctrs_eval_mask_n(fn, syms, args, env);
 }
 
+// Dispatch calls only refer to symbols, so they are created once per
+// combination of `fn_sym` and `syms` and reused. They are marked as not
+// mutable in case a method captures and modifies its call.
+#define DISPATCH_CALLS_SIZE 64
+
+static SEXP dispatch_calls = NULL;
+static R_len_t dispatch_calls_n = 0;
+
+static bool dispatch_call_has_args(SEXP call, SEXP* syms) {
+  SEXP node = CDR(call);
+
+  for (; *syms; ++syms, node = CDR(node)) {
+    if (node == R_NilValue || TAG(node) != *syms || CAR(node) != *syms) {
+      return false;
+    }
+  }
+
+  return node == R_NilValue;
+}
+
+static SEXP dispatch_call(SEXP fn_sym, SEXP* syms) {
+  for (R_len_t i = 0; i < dispatch_calls_n; ++i) {
+    SEXP call = VECTOR_ELT(dispatch_calls, i);
+    if (CAR(call) == fn_sym && dispatch_call_has_args(call, syms)) {
+      return call;
+    }
+  }
+
+  SEXP call = PROTECT(r_call(fn_sym, syms, syms));
+  MARK_NOT_MUTABLE(call);
+
+  if (dispatch_calls_n < DISPATCH_CALLS_SIZE) {
+    SET_VECTOR_ELT(dispatch_calls, dispatch_calls_n, call);
+    ++dispatch_calls_n;
+  }
+
+  UNPROTECT(1);
+  return call;
+}
+
 /**
  * Dispatch in the global environment
  *
@@ -127,9 +168,16 @@ SEXP vctrs_dispatch_n(SEXP fn_sym, SEXP fn, SEXP* syms, SEXP* args) {
   SEXP mask = PROTECT(r_new_environment(R_GlobalEnv, 4));
   Rf_defineVar(fn_sym, fn, mask);
 
-  SEXP out = vctrs_eval_mask_n_impl(fn_sym, syms, args, mask);
+  SEXP call = PROTECT(dispatch_call(fn_sym, syms));
 
-  UNPROTECT(1);
+  while (*syms) {
+    Rf_defineVar(*syms, *args, mask);
+    ++syms; ++args;
+  }
+
+  SEXP out = Rf_eval(call, mask);
+
+  UNPROTECT(2);
   return out;
 }
 SEXP vctrs_dispatch1(SEXP fn_sym, SEXP fn,
@@ -588,8 +636,80 @@ SEXP compact_rep_materialize(SEXP x) {
   return out;
 }
 
+// Initialised at load time
+SEXP compact_ranges_attrib = NULL;
+
+// p[0] = Number of ranges `n`
+// p[1] = Total size of the ranges
+// p[2, 2 + n) = 0-based starts of the ranges
+// p[2 + n, 2 + 2n) = Sizes of the ranges
+//
+// Ranges are increasing with a step of 1. They don't need to be
+// sorted and may overlap.
+SEXP compact_ranges(const int* p_starts, const int* p_sizes, R_len_t n) {
+  SEXP ranges = PROTECT(Rf_allocVector(INTSXP, 2 + 2 * n));
+  int* p = INTEGER(ranges);
+
+  int64_t total = 0;
+
+  for (R_len_t i = 0; i < n; ++i) {
+    R_len_t start = p_starts[i];
+    R_len_t size = p_sizes[i];
+
+    if (start < 0) {
+      Rf_error("Internal error: `start` must not be negative in `compact_ranges()`.");
+    }
+    if (size < 0) {
+      Rf_error("Internal error: `size` must not be negative in `compact_ranges()`.");
+    }
+
+    total += size;
+    p[2 + i] = start;
+    p[2 + n + i] = size;
+  }
+
+  if (total > R_LEN_T_MAX) {
+    Rf_errorcall(R_NilValue, "Compact ranges can't have a total size larger than %d.", R_LEN_T_MAX);
+  }
+
+  p[0] = n;
+  p[1] = total;
+
+  SET_ATTRIB(ranges, compact_ranges_attrib);
+
+  UNPROTECT(1);
+  return ranges;
+}
+
+bool is_compact_ranges(SEXP x) {
+  return ATTRIB(x) == compact_ranges_attrib;
+}
+
+// Materialize 1-based locations
+SEXP compact_ranges_materialize(SEXP x) {
+  const int* p = INTEGER_RO(x);
+  R_len_t n = p[0];
+  const int* p_starts = p + 2;
+  const int* p_sizes = p + 2 + n;
+
+  SEXP out = PROTECT(Rf_allocVector(INTSXP, p[1]));
+  int* out_data = INTEGER(out);
+
+  for (R_len_t i = 0; i < n; ++i) {
+    R_len_t loc = p_starts[i] + 1;
+    R_len_t size = p_sizes[i];
+
+    for (R_len_t j = 0; j < size; ++j, ++out_data, ++loc) {
+      *out_data = loc;
+    }
+  }
+
+  UNPROTECT(1);
+  return out;
+}
+
 bool is_compact(SEXP x) {
-  return is_compact_rep(x) || is_compact_seq(x);
+  return is_compact_rep(x) || is_compact_seq(x) || is_compact_ranges(x);
 }
 
 SEXP compact_materialize(SEXP x) {
@@ -597,6 +717,8 @@ SEXP compact_materialize(SEXP x) {
     return compact_rep_materialize(x);
   } else if (is_compact_seq(x)) {
     return compact_seq_materialize(x);
+  } else if (is_compact_ranges(x)) {
+    return compact_ranges_materialize(x);
   } else {
     return x;
   }
@@ -607,6 +729,8 @@ R_len_t vec_subscript_size(SEXP x) {
     return r_int_get(x, 1);
   } else if (is_compact_seq(x)) {
     return r_int_get(x, 1);
+  } else if (is_compact_ranges(x)) {
+    return r_int_get(x, 1);
   } else {
     return vec_size(x);
   }
@@ -1175,6 +1299,8 @@ SEXP strings_loc = NULL;
 SEXP strings_val = NULL;
 SEXP strings_group = NULL;
 SEXP strings_length = NULL;
+SEXP strings_offset = NULL;
+SEXP strings_compact = NULL;
 
 SEXP chrs_subset = NULL;
 SEXP chrs_extract = NULL;
@@ -1227,13 +1353,16 @@ void vctrs_init_utils(SEXP ns) {
 
   base_method_table = r_env_get(R_BaseNamespace, Rf_install(".__S3MethodsTable__."));
 
+  dispatch_calls = Rf_allocVector(VECSXP, DISPATCH_CALLS_SIZE);
+  R_PreserveObject(dispatch_calls);
+
   vctrs_shared_empty_str = Rf_mkString("");
   R_PreserveObject(vctrs_shared_empty_str);
 
 
   // Holds the CHARSXP objects because unlike symbols they can be
   // garbage collected
-  strings = Rf_allocVector(STRSXP, 21);
+  strings = Rf_allocVector(STRSXP, 23);
   R_PreserveObject(strings);
 
   strings_dots = Rf_mkChar("...");
@@ -1299,6 +1428,12 @@ void vctrs_init_utils(SEXP ns) {
   strings_list = Rf_mkChar("list");
   SET_STRING_ELT(strings, 20, strings_list);
 
+  strings_offset = Rf_mkChar("offset");
+  SET_STRING_ELT(strings, 21, strings_offset);
+
+  strings_compact = Rf_mkChar("compact");
+  SET_STRING_ELT(strings, 22, strings_compact);
+
 
   classes_data_frame = Rf_allocVector(STRSXP, 1);
   R_PreserveObject(classes_data_frame);
@@ -1381,6 +1516,9 @@ void vctrs_init_utils(SEXP ns) {
   SET_STRING_ELT(classes_vctrs_group_rle, 1, strings_vctrs_rcrd);
   SET_STRING_ELT(classes_vctrs_group_rle, 2, strings_vctrs_vctr);
 
+  classes_vctrs_group_loc_compact = Rf_mkString("vctrs_group_loc_compact");
+  R_PreserveObject(classes_vctrs_group_loc_compact);
+
 
   vctrs_shared_empty_lgl = Rf_allocVector(LGLSXP, 0);
   R_PreserveObject(vctrs_shared_empty_lgl);
@@ -1509,6 +1647,10 @@ void vctrs_init_utils(SEXP ns) {
   R_PreserveObject(compact_rep_attrib);
   SET_TAG(compact_rep_attrib, Rf_install("vctrs_compact_rep"));
 
+  compact_ranges_attrib = Rf_cons(R_NilValue, R_NilValue);
+  R_PreserveObject(compact_ranges_attrib);
+  SET_TAG(compact_ranges_attrib, Rf_install("vctrs_compact_ranges"));
+
   // We assume the following in `union vctrs_dbl_indicator`
   VCTRS_ASSERT(sizeof(double) == sizeof(int64_t));
   VCTRS_ASSERT(sizeof(double) == 2 * sizeof(int));
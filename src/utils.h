@@ -128,6 +128,9 @@ void init_compact_rep(int* p, R_len_t i, R_len_t n);
 SEXP compact_rep(R_len_t i, R_len_t n);
 bool is_compact_rep(SEXP x);
 
+SEXP compact_ranges(const int* p_starts, const int* p_sizes, R_len_t n);
+bool is_compact_ranges(SEXP x);
+
 bool is_compact(SEXP x);
 SEXP compact_materialize(SEXP x);
 R_len_t vec_subscript_size(SEXP x);
@@ -267,6 +270,7 @@ extern SEXP classes_posixct;
 extern SEXP classes_tibble;
 extern SEXP classes_list_of;
 extern SEXP classes_vctrs_group_rle;
+extern SEXP classes_vctrs_group_loc_compact;
 
 extern SEXP strings_dots;
 extern SEXP strings_empty;
@@ -293,6 +297,8 @@ extern SEXP strings_loc;
 extern SEXP strings_val;
 extern SEXP strings_group;
 extern SEXP strings_length;
+extern SEXP strings_offset;
+extern SEXP strings_compact;
 
 extern SEXP chrs_subset;
 extern SEXP chrs_extract;
@@ -357,8 +357,11 @@ SEXP vec_cast(SEXP x, SEXP to, struct vctrs_arg* x_arg, struct vctrs_arg* to_arg
 SEXP vec_cast_common(SEXP xs, SEXP to);
 SEXP vec_coercible_cast(SEXP x, SEXP to, struct vctrs_arg* x_arg, struct vctrs_arg* to_arg);
 SEXP vec_slice(SEXP x, SEXP index);
+SEXP vec_slice_trusted(SEXP x, SEXP subscript);
 SEXP vec_chop(SEXP x, SEXP indices);
+SEXP vec_chop_compact(SEXP x, SEXP loc, SEXP offset);
 SEXP vec_slice_shaped(enum vctrs_type type, SEXP x, SEXP index);
+SEXP vec_assign_shaped(enum vctrs_type type, SEXP proxy, SEXP index, SEXP value);
 SEXP vec_assign(SEXP x, SEXP index, SEXP value);
 bool vec_requires_fallback(SEXP x, struct vctrs_proxy_info info);
 SEXP vec_init(SEXP x, R_len_t n);
@@ -370,6 +373,14 @@ SEXP vec_recycle_fallback(SEXP x, R_len_t size, struct vctrs_arg* x_arg);
 SEXP vec_recycle_common(SEXP xs, R_len_t size);
 SEXP vec_names(SEXP x);
 SEXP vec_group_loc(SEXP x);
+SEXP vec_group_loc_compact(SEXP x);
+R_len_t group_id_fill(SEXP x, R_len_t n, int* p_groups);
+R_len_t check_group_id(SEXP group_id, R_len_t size, SEXP n_groups);
+void check_summary_numeric(SEXP x);
+void group_order_fill(const int* p_group_id, R_len_t n, R_len_t n_groups, int* p_order, int* p_offset);
+SEXP vec_group_loc_sorted(SEXP x, SEXP proxy, bool compact);
+void proxy_order_fill(SEXP x, R_len_t n, int* p_o);
+bool proxy_is_monotonic(SEXP x, R_len_t n);
 SEXP vec_match(SEXP needles, SEXP haystack);
 
 SEXP vec_c(SEXP xs,
@@ -541,8 +552,10 @@ SEXP tibble_ptype2(SEXP x, SEXP y, struct vctrs_arg* x_arg, struct vctrs_arg* y_
 
 // Character translation ----------------------------------------
 
+SEXP str_translate_utf8(SEXP x);
 SEXP obj_maybe_translate_encoding(SEXP x, R_len_t size);
 SEXP obj_maybe_translate_encoding2(SEXP x, R_len_t x_size, SEXP y, R_len_t y_size);
+SEXP obj_translate_utf8(SEXP x, R_len_t size);
 
 // Growable vector ----------------------------------------------
 